@@ -0,0 +1,116 @@
+// Implementation of AlleleCounter class
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <vector> // C++ standard vector class template
+#include "AlleleCounter.h"
+
+using namespace std;
+
+// ---Utility functions (file scope)---
+// Bitwise operations on blocks (AVX2 registers or 64-bit words)
+
+#if defined(__AVX2__)
+static inline __m256i blockLoad( const uint64_t* words ) { return _mm256_load_si256( reinterpret_cast<const __m256i*>( words ) ); }
+static inline void blockStore( uint64_t* words, __m256i x ) { _mm256_storeu_si256( reinterpret_cast<__m256i*>( words ), x ); }
+static inline __m256i blockAnd( __m256i x, __m256i y ) { return _mm256_and_si256( x, y ); }
+static inline __m256i blockOr( __m256i x, __m256i y ) { return _mm256_or_si256( x, y ); }
+static inline __m256i blockXor( __m256i x, __m256i y ) { return _mm256_xor_si256( x, y ); }
+static inline __m256i blockZero() { return _mm256_setzero_si256(); }
+static inline bool blockIsZero( __m256i x ) { return _mm256_testz_si256( x, x ); }
+#else
+static inline uint64_t blockLoad( const uint64_t* words ) { return *words; }
+static inline void blockStore( uint64_t* words, uint64_t x ) { *words = x; }
+static inline uint64_t blockAnd( uint64_t x, uint64_t y ) { return x & y; }
+static inline uint64_t blockOr( uint64_t x, uint64_t y ) { return x | y; }
+static inline uint64_t blockXor( uint64_t x, uint64_t y ) { return x ^ y; }
+static inline uint64_t blockZero() { return 0; }
+static inline bool blockIsZero( uint64_t x ) { return x == 0; }
+#endif
+
+// Carry-save adder: a + b + c = 2 high + low (bitwise)
+template<typename B>
+static inline void csa( B& high, B& low, B a, B b, B c ) {
+   B u = blockXor( a, b );
+   high = blockOr( blockAnd( a, b ), blockAnd( u, c ) );
+   low = blockXor( u, c );
+}
+
+// ---Member functions---
+
+void AlleleCounter::addTo( vector<int>& alfreq ) {
+   int64_t counts[64];
+   getCounts( counts );
+   // Locus k is bit 31-k of the lower and the upper haplotypes
+   int nloci = static_cast<int>( alfreq.size() ) < 32 ? static_cast<int>( alfreq.size() ) : 32;
+   for ( int k = 0; k < nloci; ++k ) {
+      alfreq[k] += static_cast<int>( counts[ 31 - k ] + counts[ 63 - k ] );
+   }
+}
+
+void AlleleCounter::getCounts( int64_t* counts ) {
+   if ( NBuffered > 0 ) { reduceBuffer(); }
+   // Count of each bit position (0 to 63) from the bit-sliced counters of all the block lanes
+   uint64_t planes[4 + NPlanes][BlockSize];
+   blockStore( planes[0], Ones );
+   blockStore( planes[1], Twos );
+   blockStore( planes[2], Fours );
+   blockStore( planes[3], Eights );
+   for ( int p = 0; p < NPlanesUsed; ++p ) { blockStore( planes[ 4 + p ], Sixteens[p] ); }
+   int nplanes = 4 + NPlanesUsed;
+   for ( int j = 0; j < 64; ++j ) { counts[j] = 0; }
+   for ( int p = 0; p < nplanes; ++p ) {
+      int64_t weight = static_cast<int64_t>( 1 ) << p;
+      for ( int lane = 0; lane < BlockSize; ++lane ) {
+         uint64_t word = planes[p][lane];
+         while ( word != 0 ) { // only the 1-bits
+            counts[ __builtin_ctzll( word ) ] += weight;
+            word &= word - 1;
+         }
+      }
+   }
+   reset();
+}
+
+// ---Utility functions---
+
+void AlleleCounter::reduceBuffer() {
+   for ( int i = NBuffered; i < BufferSize; ++i ) { Buffer[i] = 0; }
+   NBuffered = 0;
+   // Harley-Seal tree of carry-save adders over the 16 blocks
+   Block twosA, twosB, foursA, foursB, eightsA, eightsB, sixteens;
+   const uint64_t* data = Buffer;
+   csa( twosA, Ones, Ones, blockLoad( data ), blockLoad( data + BlockSize ) );
+   csa( twosB, Ones, Ones, blockLoad( data + 2 * BlockSize ), blockLoad( data + 3 * BlockSize ) );
+   csa( foursA, Twos, Twos, twosA, twosB );
+   csa( twosA, Ones, Ones, blockLoad( data + 4 * BlockSize ), blockLoad( data + 5 * BlockSize ) );
+   csa( twosB, Ones, Ones, blockLoad( data + 6 * BlockSize ), blockLoad( data + 7 * BlockSize ) );
+   csa( foursB, Twos, Twos, twosA, twosB );
+   csa( eightsA, Fours, Fours, foursA, foursB );
+   csa( twosA, Ones, Ones, blockLoad( data + 8 * BlockSize ), blockLoad( data + 9 * BlockSize ) );
+   csa( twosB, Ones, Ones, blockLoad( data + 10 * BlockSize ), blockLoad( data + 11 * BlockSize ) );
+   csa( foursA, Twos, Twos, twosA, twosB );
+   csa( twosA, Ones, Ones, blockLoad( data + 12 * BlockSize ), blockLoad( data + 13 * BlockSize ) );
+   csa( twosB, Ones, Ones, blockLoad( data + 14 * BlockSize ), blockLoad( data + 15 * BlockSize ) );
+   csa( foursB, Twos, Twos, twosA, twosB );
+   csa( eightsB, Fours, Fours, foursA, foursB );
+   csa( sixteens, Eights, Eights, eightsA, eightsB );
+   // Ripple-carry increment of the counter of weight 16
+   Block carry = sixteens;
+   for ( int p = 0; p < NPlanes && !blockIsZero( carry ); ++p ) {
+      Block next = blockAnd( Sixteens[p], carry );
+      Sixteens[p] = blockXor( Sixteens[p], carry );
+      carry = next;
+      if ( p >= NPlanesUsed ) { NPlanesUsed = p + 1; }
+   }
+}
+
+void AlleleCounter::reset() {
+   NBuffered = 0;
+   Ones = Twos = Fours = Eights = blockZero();
+   for ( int p = 0; p < NPlanes; ++p ) { Sixteens[p] = blockZero(); }
+   NPlanesUsed = 0;
+}
+
+// ---Constructor---
+
+AlleleCounter::AlleleCounter() { reset(); }
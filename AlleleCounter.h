@@ -0,0 +1,61 @@
+// AlleleCounter class definition
+
+/* Counter of the alleles "1" per locus of a set of genotypes (a population, or the whole symbiont
+   metapopulation), without looping over the bits of each genotype (positional popcount).
+   The genotypes are added to a buffer, and each full buffer of 16 blocks is reduced with a tree of
+   carry-save adders (Harley-Seal) into bit-sliced counters: bit j of Ones, Twos, Fours and Eights
+   holds the bits of weight 1, 2, 4 and 8 of the count of bit position j, and the carries of weight 16
+   are added to the ripple counter Sixteens. A block is one genotype (64 bit positions: both haplotypes),
+   or four genotypes in an AVX2 register when the compiler targets AVX2 (e.g. -mavx2 or -march=native).
+   The counts per locus are only assembled when they are read (addTo).
+   As in Population::getAlFreq, locus k (0 <= k < 32) is bit 31-k of each haplotype (addTo); the counts
+   of the 64 bit positions can also be read directly (getCounts), e.g. for the multi-word genomes of Genome.
+*/
+
+#ifndef ALLELECOUNTER_H
+#define ALLELECOUNTER_H
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <vector> // C++ standard vector class template
+#if defined(__AVX2__)
+#include <immintrin.h> // AVX2 intrinsics
+#endif
+
+class AlleleCounter {
+public:
+
+   AlleleCounter(); // constructor
+
+   // Add the alleles of a genotype (both haplotypes)
+   void add( uint64_t gen ) {
+      Buffer[ NBuffered++ ] = gen;
+      if ( NBuffered == BufferSize ) { reduceBuffer(); }
+   }
+   void addTo( std::vector<int>& ); // Add the number of alleles "1" per locus to a vector of allele frequencies, and reset the counter
+   void getCounts( int64_t* ); // Get the number of 1-bits of each of the 64 bit positions of the added words, and reset the counter
+
+private:
+
+#if defined(__AVX2__)
+   typedef __m256i Block; // Four genotypes
+   static const int BlockSize = 4; // Number of genotypes per block
+#else
+   typedef uint64_t Block; // One genotype
+   static const int BlockSize = 1; // Number of genotypes per block
+#endif
+   static const int NBlocks = 16; // Number of blocks reduced at once
+   static const int BufferSize = NBlocks * BlockSize; // Number of buffered genotypes
+   static const int NPlanes = 27; // Number of bit planes of Sixteens (up to 2^31 genotypes per block lane)
+
+   alignas(32) uint64_t Buffer[BufferSize]; // Genotypes not reduced yet
+   int NBuffered; // Number of genotypes in Buffer
+   Block Ones, Twos, Fours, Eights; // Bit-sliced counts of weight 1, 2, 4 and 8
+   Block Sixteens[NPlanes]; // Bit-sliced ripple counter of the carries of weight 16
+   int NPlanesUsed; // Number of planes of Sixteens that may be non-zero
+
+   // Utility functions
+   void reduceBuffer(); // Reduce the buffer (padded with zeros if it is not full) into the bit-sliced counters
+   void reset(); // Set all the counts to zero
+   };
+
+   #endif // ALLELECOUNTER_H
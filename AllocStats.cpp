@@ -0,0 +1,32 @@
+// Implementation of AllocStats class and replacement of the global operator new/delete
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <cstdlib> // malloc() and free() functions
+#include <new>
+#include "AllocStats.h"
+
+// ---Static member functions---
+
+uint64_t AllocStats::getNAllocs() {return NAllocs;}
+uint64_t AllocStats::getNBytes() {return NBytes;}
+
+// ---Static data members---
+uint64_t AllocStats::NAllocs = 0;
+uint64_t AllocStats::NBytes = 0;
+
+// ---Constructor---
+
+AllocStats::AllocStats() {}
+
+// ---Replaceable global allocation functions---
+// (array and nothrow versions call these by default)
+
+void* operator new( std::size_t size ) {
+   AllocStats::addAlloc( size );
+   if ( void* ptr = std::malloc( size ? size : 1 ) ) { return ptr; }
+   throw std::bad_alloc();
+}
+
+void operator delete( void* ptr ) noexcept { std::free( ptr ); }
+
+void operator delete( void* ptr, std::size_t ) noexcept { std::free( ptr ); }
@@ -0,0 +1,34 @@
+// AllocStats class definition
+
+/* Heap allocation counters.
+   AllocStats.cpp replaces the global operator new/delete, so that every heap allocation of the
+   program (including those of the standard containers) increments the number of allocations and
+   the number of requested bytes. The Profiler class takes snapshots of these counters at the start
+   and at the end of each phase of the main loop to attribute allocations to phases.
+*/
+
+#ifndef ALLOCSTATS_H
+#define ALLOCSTATS_H
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <cstddef> // size_t type
+
+class AllocStats {
+public:
+
+   AllocStats(); // constructor
+
+   // Static member functions
+
+   static void addAlloc( std::size_t size ) { ++NAllocs; NBytes += size; } // Count one allocation (called by operator new)
+
+   static uint64_t getNAllocs(); // Get the number of allocations since the start of the program
+   static uint64_t getNBytes(); // Get the number of bytes allocated since the start of the program
+
+private:
+
+   static uint64_t NAllocs; // Number of calls to operator new
+   static uint64_t NBytes; // Number of bytes requested from operator new
+   };
+
+   #endif // ALLOCSTATS_H
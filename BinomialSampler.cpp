@@ -0,0 +1,92 @@
+// Implementation of BinomialSampler class
+
+#include <cmath>
+#include <vector> // C++ standard vector class template
+#include "BinomialSampler.h"
+#include "Rng.h"
+
+using namespace std;
+
+// ---Member functions---
+
+void BinomialSampler::setProb( double prob ) {
+   Prob = prob;
+   Flip = ( prob > 0.5 );
+   P = Flip ? 1 - prob : prob;
+   Q = 1 - P;
+   Ratio = ( Q > 0 ) ? P / Q : 0;
+   LogRatio = ( P > 0 && Q > 0 ) ? log( Ratio ) : 0;
+   for ( int i = 0; i < NCache; ++i ) { Cache[i].N = -1; }
+}
+
+double BinomialSampler::getProb() const {return Prob;}
+
+int BinomialSampler::sample( int n ) {
+   if ( n <= 0 || P <= 0 ) { return ( ( n > 0 && Flip ) ? n : 0 ); } // Prob = 0 or Prob = 1
+   const TrialSetup& setup = getSetup( n );
+   int k = ( n * P < BtrsMin ) ? sampleInversion( n, setup ) : sampleBtrs( n, setup );
+   return ( Flip ? n - k : k );
+}
+
+void BinomialSampler::sample( const std::vector<int>& trials, std::vector<int>& results ) {
+   results.resize( trials.size() );
+   for ( size_t i = 0; i < trials.size(); ++i ) { results[i] = sample( trials[i] ); }
+}
+
+// ---Utility functions---
+
+const BinomialSampler::TrialSetup& BinomialSampler::getSetup( int n ) {
+   TrialSetup& setup = Cache[ n % NCache ];
+   if ( setup.N == n ) { return setup; }
+   setup.N = n;
+   if ( n * P < BtrsMin ) {
+      setup.Qn = pow( Q, n );
+   }
+   else {
+      double spq = sqrt( n * P * Q );
+      setup.B = 1.15 + 2.53 * spq;
+      setup.A = -0.0873 + 0.0248 * setup.B + 0.01 * P;
+      setup.C = n * P + 0.5;
+      setup.Alpha = ( 2.83 + 5.1 / setup.B ) * spq;
+      setup.Vr = 0.92 - 4.2 / setup.B;
+      setup.M = floor( ( n + 1 ) * P );
+      setup.H = lgamma( setup.M + 1 ) + lgamma( n - setup.M + 1 );
+   }
+   return setup;
+}
+
+int BinomialSampler::sampleInversion( int n, const TrialSetup& setup ) {
+   while ( true ) {
+      double u = Rng::unif_01();
+      double prob = setup.Qn; // P(X = 0)
+      int k = 0;
+      while ( u > prob ) {
+         u -= prob;
+         ++k;
+         if ( k > n ) { break; } // rounding error: sample again
+         prob *= Ratio * ( n - k + 1 ) / k;
+      }
+      if ( k <= n ) { return k; }
+   }
+}
+
+int BinomialSampler::sampleBtrs( int n, const TrialSetup& setup ) {
+   // W. Hörmann (1993) The generation of binomial random variates.
+   // Journal of Statistical Computation and Simulation 46:101-110
+   while ( true ) {
+      double u = Rng::unif_01() - 0.5;
+      double v = Rng::unif_01();
+      double us = 0.5 - fabs( u );
+      double k = floor( ( 2 * setup.A / us + setup.B ) * u + setup.C );
+      if ( k < 0 || k > n ) { continue; }
+      if ( us >= 0.07 && v <= setup.Vr ) { return static_cast<int>( k ); } // squeeze
+      v = log( v * setup.Alpha / ( setup.A / ( us * us ) + setup.B ) );
+      if ( v <= setup.H - lgamma( k + 1 ) - lgamma( n - k + 1 ) + ( k - setup.M ) * LogRatio ) {
+         return static_cast<int>( k );
+      }
+   }
+}
+
+// ---Constructor---
+
+BinomialSampler::BinomialSampler( double prob ) { setProb( prob ); }
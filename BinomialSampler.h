@@ -0,0 +1,54 @@
+// BinomialSampler class definition
+
+/* Binomial sampler for a fixed probability of success, reused across calls with any number of trials.
+   The setup that depends only on the probability is computed once (setProb), and the setup that
+   depends on the number of trials is kept in a small cache of the last values of n:
+      n p < 10   inversion from 0 (needs q^n)
+      n p >= 10  transformed rejection with squeeze BTRS (Hörmann 1993)
+   Probabilities above 0.5 are sampled as n minus a binomial with probability 1 - p.
+   The uniform deviates come from Rng::unif_01, so the sampler follows the engine and substream of Rng.
+*/
+
+#ifndef BINOMIALSAMPLER_H
+#define BINOMIALSAMPLER_H
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <vector> // C++ standard vector class template
+
+class BinomialSampler {
+public:
+
+   explicit BinomialSampler( double = 0 ); // constructor (parameter: probability of success)
+
+   void setProb( double ); // Set the probability of success (and compute its setup)
+   double getProb() const; // Get the probability of success
+
+   int sample( int ); // Sample the number of successes in n trials
+   void sample( const std::vector<int>&, std::vector<int>& ); // Sample one number of successes per number of trials
+
+private:
+
+   static const int NCache = 32; // Number of cached numbers of trials (direct-mapped by n)
+   static constexpr double BtrsMin = 10; // Minimum n p for the BTRS method
+
+   struct TrialSetup { // Setup that depends on the number of trials
+      int N; // number of trials (-1 if empty)
+      double Qn; // q^n (inversion)
+      double M, H, A, B, C, Alpha, Vr; // constants of BTRS
+   };
+
+   double Prob; // Probability of success
+   double P; // min( Prob, 1 - Prob )
+   bool Flip; // Whether Prob > 0.5 (the sample is n minus the sample of P)
+   double Q; // 1 - P
+   double Ratio; // P / Q
+   double LogRatio; // log( P / Q )
+   TrialSetup Cache[NCache]; // Setup of the last numbers of trials
+
+   // Utility functions
+   const TrialSetup& getSetup( int ); // Get (computing it if needed) the setup of n trials
+   int sampleInversion( int, const TrialSetup& ); // Inversion (small n p)
+   int sampleBtrs( int, const TrialSetup& ); // BTRS (large n p)
+   };
+
+   #endif // BINOMIALSAMPLER_H
@@ -11,18 +11,18 @@
 using namespace std;
 
 // constructor
-Gamete::Gamete(uint32_t hgen): HaplGen(hgen) {}
+Gamete::Gamete(const ModelGenome::Hapl& hgen): HaplGen(hgen) {}
 
 // Set HaplGen
-void Gamete::setHaplGen(uint32_t hgen) {HaplGen = hgen;}
+void Gamete::setHaplGen(const ModelGenome::Hapl& hgen) {HaplGen = hgen;}
 
 // Get HaplGen
-uint32_t Gamete::getHaplGen() const {return HaplGen;}
+const ModelGenome::Hapl& Gamete::getHaplGen() const {return HaplGen;}
 
 // Print HaplGen
 void Gamete::printHaplGen() const {
    cout << "Haploid genotype: " << endl;
-   displayBits(HaplGen);
+   for (int w = 0; w < ModelGenome::HaplWords32; ++w) { displayBits(ModelGenome::word32(HaplGen, w)); }
 }
 
 // ---Utility functions---
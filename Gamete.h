@@ -5,18 +5,19 @@
 
 #include <cstdint> // uint32_t and uint64_t types
 #include <string>
+#include "Genome.h" // ModelGenome (genotype storage chosen at compile time)
 
 class Gamete {
 public:
-   explicit Gamete(uint32_t = 0);
+   explicit Gamete(const ModelGenome::Hapl& = ModelGenome::Hapl());
 
-   void setHaplGen(uint32_t);
-   uint32_t getHaplGen() const;
+   void setHaplGen(const ModelGenome::Hapl&);
+   const ModelGenome::Hapl& getHaplGen() const;
 
    void printHaplGen() const;
 
 private:
-   uint32_t HaplGen; // genotype
+   ModelGenome::Hapl HaplGen; // genotype
 
    // Utility functions
    void displayBits(uint32_t) const;
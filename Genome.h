@@ -0,0 +1,310 @@
+// Genome class template definition
+// Member functions are defined within the class definition's body so that they can be inlined
+
+/* Storage and bitwise operations of the diploid genotype of an individual, parameterised by its
+   number NW of 64-bit words. The genome of the model is chosen at compile time:
+      (default)           Genome<1>: one 64-bit word, i.e. two haplotypes of up to 32 loci (the lower
+                          32 bits hold the haplotype of the second gamete and the upper 32 bits that of
+                          the first one). This specialisation is the single-word fast path.
+      -DGENOME_WORDS=NW   Genome<NW> (NW even): NW/2 words per haplotype, i.e. up to 32 NW loci
+                          (e.g. -DGENOME_WORDS=32 for 1024 loci). Locus k is bit k%64 of word k/64 of
+                          each haplotype; words 0 to NW/2-1 hold haplotype 0 (second gamete) and words
+                          NW/2 to NW-1 haplotype 1 (first gamete).
+   The number of loci L (Param) must not exceed MaxL, and Genome<1> holds exactly 32 loci (its operations
+   use all the bits of the word, as in the original model). Both versions have the same interface:
+      Gen, Hapl       types of a diploid genotype and of a haploid genotype (gamete)
+      fromGametes     diploid genotype of a newborn from the haploid genotypes of its parental gametes
+      recombine       haploid genotype of a gamete by free recombination (random alleles at the heterozygous loci)
+      selectAlleles   haploid genotype taking the alleles of haplotype 1 where a mask is set and those of haplotype 0
+                      elsewhere; lociFrom is the mask of the loci from a given one, xorHapl combines masks (see LinkageMap)
+      countOnes       number of alleles "1" (phenotype), nAlleles the number of alleles it is compared with
+      countHet        number of heterozygous loci; sumHet does the same for an array of genotypes
+      flipAllele      mutation of one allele (0 <= allele < 2L), mutate applies the mutations of a MutationScatter
+      randomGen       random genotype with k alleles "1" among the 2L alleles
+      lessGen         order of genotypes, equalGen their equality (e.g. to group identical genotypes)
+      locusOfBit      locus coded by a bit of the words of a diploid genotype (bit b is bit b%64 of word b/64)
+      Counter         counter of the alleles "1" per locus (see AlleleCounter)
+*/
+
+#ifndef GENOME_H
+#define GENOME_H
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <cstddef> // size_t type
+#include <string>
+#include <bitset>
+#include <vector> // C++ standard vector class template
+#include "Rng.h"
+#include "MutationScatter.h"
+#include "AlleleCounter.h"
+
+#ifndef GENOME_WORDS
+#define GENOME_WORDS 1 // Number of 64-bit words per diploid genotype (1: single-word fast path)
+#endif
+
+/**** Primary template: NW words (NW/2 per haplotype) ****/
+template<int NW>
+class Genome {
+public:
+   static_assert( NW >= 2 && NW % 2 == 0, "GENOME_WORDS must be 1 or an even number" );
+
+   static const int NWords = NW; // Number of 64-bit words per diploid genotype
+   static const int HaplWords = NW / 2; // Number of 64-bit words per haplotype
+   static const int MaxL = 64 * HaplWords; // Maximum number of loci
+
+   struct Hapl { // Haploid genotype
+      uint64_t W[HaplWords];
+   };
+   struct Gen { // Diploid genotype (haplotype 0 in W[0] to W[HaplWords-1], haplotype 1 in the rest)
+      uint64_t W[NW];
+   };
+
+   // Words of a diploid genotype (e.g. for hashing)
+   static uint64_t word( const Gen& gen, int i ) { return gen.W[i]; }
+
+   // Haplotype h (0 or 1) of a diploid genotype
+   static Hapl haplotype( const Gen& gen, int h ) {
+      Hapl hapl;
+      for ( int w = 0; w < HaplWords; ++w ) { hapl.W[w] = gen.W[ h * HaplWords + w ]; }
+      return hapl;
+   }
+
+   // 32-bit words of a haplotype (for printing)
+   static const int HaplWords32 = 2 * HaplWords;
+   static uint32_t word32( const Hapl& hapl, int i ) { return static_cast<uint32_t>( hapl.W[ i / 2 ] >> ( 32 * ( i % 2 ) ) ); }
+
+   static Gen fromGametes( const Hapl& hapl1, const Hapl& hapl2 ) {
+      Gen gen;
+      for ( int w = 0; w < HaplWords; ++w ) {
+         gen.W[w] = hapl2.W[w];
+         gen.W[ HaplWords + w ] = hapl1.W[w];
+      }
+      return gen;
+   }
+
+   static Hapl recombine( const Gen& gen ) {
+      // One random 64-bit mask per word, drawn in one call; the loop over the words can be vectorised
+      uint32_t bits[NW];
+      Rng::fillRandomBits( bits, NW );
+      Hapl hapl;
+      for ( int w = 0; w < HaplWords; ++w ) {
+         uint64_t mask = static_cast<uint64_t>( bits[ 2 * w + 1 ] ) << 32 | bits[ 2 * w ];
+         uint64_t h0 = gen.W[w];
+         uint64_t h1 = gen.W[ HaplWords + w ];
+         hapl.W[w] = ( h0 | h1 ) ^ ( ( h0 ^ h1 ) & ~mask ); // random allele at the heterozygous loci
+      }
+      return hapl;
+   }
+
+   static Hapl selectAlleles( const Gen& gen, const Hapl& mask ) {
+      Hapl hapl;
+      for ( int w = 0; w < HaplWords; ++w ) {
+         uint64_t h0 = gen.W[w];
+         hapl.W[w] = h0 ^ ( ( h0 ^ gen.W[ HaplWords + w ] ) & mask.W[w] );
+      }
+      return hapl;
+   }
+
+   static Hapl lociFrom( int locus ) {
+      Hapl mask;
+      for ( int w = 0; w < HaplWords; ++w ) {
+         if ( 64 * ( w + 1 ) <= locus ) { mask.W[w] = 0; }
+         else if ( 64 * w >= locus ) { mask.W[w] = ~static_cast<uint64_t>( 0 ); }
+         else { mask.W[w] = ~static_cast<uint64_t>( 0 ) << ( locus % 64 ); }
+      }
+      return mask;
+   }
+
+   static void xorHapl( Hapl& mask, const Hapl& other ) {
+      for ( int w = 0; w < HaplWords; ++w ) { mask.W[w] ^= other.W[w]; }
+   }
+
+   static int countOnes( const Gen& gen ) {
+      int ones = 0;
+      for ( int w = 0; w < NW; ++w ) { ones += popcount64( gen.W[w] ); }
+      return ones;
+   }
+
+   static constexpr int nAlleles( int l ) { return 2 * l; }
+
+   static int countHet( const Gen& gen ) {
+      int het = 0;
+      for ( int w = 0; w < HaplWords; ++w ) { het += popcount64( gen.W[w] ^ gen.W[ HaplWords + w ] ); }
+      return het;
+   }
+
+   static int64_t sumHet( const Gen* gens, size_t n ) {
+      int64_t het = 0;
+      for ( size_t i = 0; i < n; ++i ) { het += countHet( gens[i] ); }
+      return het;
+   }
+
+   static void flipAllele( Gen& gen, int allele, int l ) {
+      int h = allele / l; // haplotype
+      int locus = allele % l;
+      gen.W[ h * HaplWords + locus / 64 ] ^= static_cast<uint64_t>( 1 ) << ( locus % 64 );
+   }
+
+   static void mutate( Gen& gen, MutationScatter& mutations, int l, Rng& rng ) {
+      for ( int allele = mutations.nextAllele( 2 * l, rng ); allele >= 0; allele = mutations.nextAllele( 2 * l, rng ) ) {
+         flipAllele( gen, allele, l );
+      }
+   }
+
+   static Gen randomGen( int k, int l, Rng& rng ) {
+      // k alleles "1" among the 2L alleles, scattered into both haplotypes
+      uint64_t alleles[NW] = {};
+      rng.random_k_bits( k, 2 * l, alleles );
+      Gen gen = Gen();
+      for ( int w = 0; w < NW; ++w ) {
+         for ( uint64_t bits = alleles[w]; bits != 0; bits &= bits - 1 ) {
+            flipAllele( gen, 64 * w + __builtin_ctzll( bits ), l );
+         }
+      }
+      return gen;
+   }
+
+   static bool lessGen( const Gen& gen1, const Gen& gen2 ) {
+      for ( int w = NW - 1; w >= 0; --w ) {
+         if ( gen1.W[w] != gen2.W[w] ) { return gen1.W[w] < gen2.W[w]; }
+      }
+      return false;
+   }
+
+   static bool equalGen( const Gen& gen1, const Gen& gen2 ) {
+      for ( int w = 0; w < NW; ++w ) {
+         if ( gen1.W[w] != gen2.W[w] ) { return false; }
+      }
+      return true;
+   }
+
+   static int locusOfBit( int bit ) { return 64 * ( ( bit / 64 ) % HaplWords ) + bit % 64; }
+
+   static std::string toString( const Gen& gen ) {
+      std::string output;
+      for ( int w = NW - 1; w >= 0; --w ) { output += std::bitset<64>( gen.W[w] ).to_string() + ( w > 0 ? " " : "" ); }
+      return output;
+   }
+
+   class Counter { // Counter of the alleles "1" per locus (one bit-sliced counter per word of the haplotypes)
+   public:
+      void add( const Gen& gen ) {
+         for ( int w = 0; w < HaplWords; ++w ) {
+            Counters[w].add( gen.W[w] );
+            Counters[w].add( gen.W[ HaplWords + w ] );
+         }
+      }
+      void addTo( std::vector<int>& alfreq ) { // locus k is bit k%64 of word k/64
+         int64_t counts[64];
+         for ( int w = 0; w < HaplWords; ++w ) {
+            Counters[w].getCounts( counts );
+            for ( int b = 0; b < 64 && 64 * w + b < static_cast<int>( alfreq.size() ); ++b ) {
+               alfreq[ 64 * w + b ] += static_cast<int>( counts[b] );
+            }
+         }
+      }
+   private:
+      AlleleCounter Counters[HaplWords];
+   };
+
+private:
+   static int popcount64( uint64_t x ) {
+      x -= ( x >> 1 ) & 0x5555555555555555;
+      x = ( x & 0x3333333333333333 ) + ( ( x >> 2 ) & 0x3333333333333333 );
+      x = ( x + ( x >> 4 ) ) & 0x0f0f0f0f0f0f0f0f;
+      return static_cast<int>( ( x * 0x0101010101010101 ) >> 56 );
+   }
+   };
+
+/**** Specialisation for one word (fast path, up to 32 loci) ****/
+template<>
+class Genome<1> {
+public:
+   static const int NWords = 1; // Number of 64-bit words per diploid genotype
+   static const int MaxL = 32; // Maximum number of loci
+
+   typedef uint32_t Hapl; // Haploid genotype
+   typedef uint64_t Gen; // Diploid genotype (haplotype 0 in the lower 32 bits, haplotype 1 in the upper 32 bits)
+
+   static uint64_t word( const Gen& gen, int ) { return gen; }
+
+   static Hapl haplotype( const Gen& gen, int h ) { return static_cast<uint32_t>( h == 0 ? gen : gen >> 32 ); }
+
+   static const int HaplWords32 = 1;
+   static uint32_t word32( const Hapl& hapl, int ) { return hapl; }
+
+   static Gen fromGametes( const Hapl& hapl1, const Hapl& hapl2 ) {
+      // (uint64_t) mostSignificantWord << 32 | leastSignificantWord
+      return static_cast<uint64_t>( hapl1 ) << 32 | hapl2;
+   }
+
+   static Hapl recombine( const Gen& gen ) {
+      uint32_t Hplgen1 = static_cast<uint32_t>( gen );
+      uint32_t Hplgen2 = static_cast<uint32_t>( gen >> 32 );
+      uint32_t Randuint32 = Rng::getLegacy() ? Rng::random_uint32() : Rng::random_bits32(); // random alleles at the heterozygous loci
+      // Step 1
+      uint32_t A = Hplgen1 ^ Hplgen2;
+      // Step2
+      uint32_t B = Hplgen1 | A;
+      // Step3
+      uint32_t C = ( A & ( Randuint32 ^ 0xFFFFFFFF ) );
+      // Step4
+      return( B ^ C );
+   }
+
+   static Hapl selectAlleles( const Gen& gen, const Hapl& mask ) {
+      uint32_t h0 = static_cast<uint32_t>( gen );
+      return( h0 ^ ( ( h0 ^ static_cast<uint32_t>( gen >> 32 ) ) & mask ) );
+   }
+
+   static Hapl lociFrom( int locus ) { return static_cast<uint32_t>( ( 1ULL << ( 32 - locus ) ) - 1 ); } // locus k is bit 31-k
+
+   static void xorHapl( Hapl& mask, const Hapl& other ) { mask ^= other; }
+
+   static int countOnes( const Gen& gen ) {
+      uint64_t x = gen;
+      x -= (x >> 1) & 0x5555555555555555;             //put count of each 2 bits into those 2 bits
+      x = (x & 0x3333333333333333) + ((x >> 2) & 0x3333333333333333); //put count of each 4 bits into those 4 bits
+      x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0f;        //put count of each 8 bits into those 8 bits
+      x += x >>  8;  //put count of each 16 bits into their lowest 8 bits
+      x += x >> 16;  //put count of each 32 bits into their lowest 8 bits
+      x += x >> 32;  //put count of each 64 bits into their lowest 8 bits
+      return static_cast<int>( x & 0x7f );
+   }
+
+   static constexpr int nAlleles( int ) { return 64; } // all the bits of the word, as in the original model
+
+   static int countHet( const Gen& gen ) { return countOnes( ( gen ^ ( gen >> 32 ) ) & 0xFFFFFFFF ); }
+
+   static int64_t sumHet( const Gen* gens, size_t n ) {
+      // One popcount per two genotypes: the XOR of the haplotypes of the first genotype in the lower half,
+      // and that of the second genotype in the upper half (the loop has no branches and can be vectorised)
+      int64_t het = 0;
+      size_t i = 0;
+      for ( ; i + 1 < n; i += 2 ) {
+         het += countOnes( ( ( gens[i] ^ ( gens[i] >> 32 ) ) & 0xFFFFFFFF ) | ( ( gens[i+1] ^ ( gens[i+1] << 32 ) ) & 0xFFFFFFFF00000000 ) );
+      }
+      if ( i < n ) { het += countHet( gens[i] ); }
+      return het;
+   }
+
+   static void flipAllele( Gen& gen, int allele, int ) { gen ^= 1ULL << allele; }
+
+   static void mutate( Gen& gen, MutationScatter& mutations, int l, Rng& rng ) { gen ^= mutations.nextMask( 2 * l, rng ); }
+
+   static Gen randomGen( int k, int, Rng& rng ) { return rng.random_k_bits( k ); } // among the 64 bits, as in the original model
+
+   static bool lessGen( const Gen& gen1, const Gen& gen2 ) { return gen1 < gen2; }
+
+   static bool equalGen( const Gen& gen1, const Gen& gen2 ) { return gen1 == gen2; }
+
+   static int locusOfBit( int bit ) { return 31 - bit % 32; } // locus k is bit 31-k of each haplotype
+
+   static std::string toString( const Gen& gen ) { return std::bitset<64>( gen ).to_string(); }
+
+   typedef AlleleCounter Counter; // locus k is bit 31-k of each haplotype
+   };
+
+typedef Genome<GENOME_WORDS> ModelGenome; // Genome of the hosts and symbionts of the model
+
+#endif // GENOME_H
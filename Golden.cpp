@@ -0,0 +1,185 @@
+// Implementation of Golden class
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <cstdlib> // exit() function
+#include <string>
+#include <iomanip>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "Golden.h"
+#include "Simul.h"
+#include "Rng.h"
+#include "Population.h"
+#include "Metapopulation.h"
+
+using namespace std;
+
+// ---Static member functions---
+
+void Golden::setMode( const string& mode ) {
+   if ( mode == "off" ) { Mode = ModeOff; }
+   else if ( mode == "record" ) { Mode = ModeRecord; }
+   else if ( mode == "verify" ) { Mode = ModeVerify; }
+   else if ( mode == "auto" ) { Mode = ModeAuto; }
+   else {
+      cerr << "Error: unknown golden mode \"" << mode << "\" (use off, record, verify or auto)" << endl;
+      exit(1);
+   }
+}
+int Golden::getMode() {return Mode;}
+
+void Golden::setStateHash( bool statehash ) { StateHash = statehash; }
+bool Golden::getStateHash() {return StateHash;}
+
+void Golden::init() {
+   if ( Mode == ModeOff ) { return; }
+   ifstream fgolden( getFileName() );
+   if ( Mode == ModeAuto ) { Mode = fgolden.is_open() ? ModeVerify : ModeRecord; }
+   if ( Mode == ModeVerify ) {
+      if ( !fgolden.is_open() ) {
+         cerr << "Error: golden file " << getFileName() << " could not be opened" << endl;
+         exit(1);
+      }
+      // A replay is only possible from a stored RNG state (or from the master seed in stream mode or FromSeed)
+      ifstream frand( Rng::getStateFileName() );
+      if ( !Rng::getStreamMode() && !Rng::getFromSeed() && !frand.is_open() ) {
+         cerr << "Error: golden verification needs the stored RNG state " << Rng::getStateFileName() << endl;
+         exit(1);
+      }
+      string line;
+      getline( fgolden, line ); // header
+      while ( getline( fgolden, line ) ) {
+         istringstream fields( line );
+         string row, rowhash, statehash;
+         getline( fields, row, ',' );
+         getline( fields, rowhash, ',' );
+         getline( fields, statehash, ',' );
+         GoldenRowHash.push_back( stoull( rowhash, nullptr, 16 ) );
+         GoldenStateHash.push_back( statehash.empty() ? 0 : stoull( statehash, nullptr, 16 ) );
+      }
+   }
+   else { // ModeRecord
+      GoldenFile.open( getFileName() );
+      if( !GoldenFile ) { // file couldn't be opened
+         cerr << "Error: golden file " << getFileName() << " could not be opened" << endl;
+         exit(1);
+      }
+      GoldenFile << "Row" << ","
+         << "RowHash" << ","
+         << "StateHash" << "\n";
+   }
+   NRows = 0;
+   NMismatches = 0;
+   FirstMismatch = -1;
+}
+
+void Golden::checkRow( const string& row, const Population<Host>& hpop, const Metapopulation<Population<Symbiont>>& smpop ) {
+   if ( Mode == ModeOff ) { return; }
+   uint64_t rowhash = hashString( row );
+   uint64_t statehash = StateHash ? hashState( hpop, smpop ) : 0;
+   if ( Mode == ModeRecord ) {
+      GoldenFile << NRows << ","
+         << hex << setw(16) << setfill('0') << rowhash << ","
+         << setw(16) << statehash << dec << setfill(' ') << "\n";
+   }
+   else { // ModeVerify
+      bool match = ( NRows < static_cast<int>( GoldenRowHash.size() ) )
+         && ( rowhash == GoldenRowHash[NRows] )
+         && ( !StateHash || GoldenStateHash[NRows] == 0 || statehash == GoldenStateHash[NRows] );
+      if ( !match ) {
+         if ( FirstMismatch < 0 ) {
+            FirstMismatch = NRows;
+            cerr << "Golden mismatch at output row " << NRows << ": " << row;
+         }
+         ++NMismatches;
+      }
+   }
+   ++NRows;
+}
+
+bool Golden::finish() {
+   if ( Mode == ModeOff ) { return true; }
+   if ( Mode == ModeRecord ) {
+      GoldenFile.close();
+      cout << "Golden file recorded: " << getFileName() << " (" << NRows << " rows)" << endl;
+      return true;
+   }
+   if ( NRows != static_cast<int>( GoldenRowHash.size() ) ) {
+      cerr << "Golden mismatch: " << NRows << " output rows, " << GoldenRowHash.size() << " rows in the golden file" << endl;
+      return false;
+   }
+   if ( NMismatches > 0 ) {
+      cerr << "Golden verification FAILED: " << NMismatches << " of " << NRows << " rows differ (first at row " << FirstMismatch << ")" << endl;
+      return false;
+   }
+   cout << "Golden verification passed: " << NRows << " rows" << ( StateHash ? " (with state hashes)" : "" ) << endl;
+   return true;
+}
+
+uint64_t Golden::hashString( const string& str, uint64_t hash ) {
+   for ( unsigned char c : str ) {
+      hash ^= c;
+      hash *= FnvPrime;
+   }
+   return hash;
+}
+
+uint64_t Golden::hashState( const Population<Host>& hpop, const Metapopulation<Population<Symbiont>>& smpop ) {
+   uint64_t hash = FnvOffset;
+   // Host population
+   hash = hashWord( hash, static_cast<uint64_t>( hpop.getN() ) );
+   const std::vector<Host> hosts = hpop.getPop();
+   for ( int i = 0; i < hpop.getN(); ++i ) {
+      const Host& host = hosts[i];
+      hash = hashWord( hash, static_cast<uint64_t>( host.getSex() ) );
+      for ( int w = 0; w < ModelGenome::NWords; ++w ) { hash = hashWord( hash, ModelGenome::word( host.getGen(), w ) ); }
+      hash = hashWord( hash, host.getID() );
+      hash = hashWord( hash, static_cast<uint64_t>( host.getNsymbiont() ) );
+      hash = hashWord( hash, host.getSPopID() );
+   }
+   // Symbiont metapopulation
+   hash = hashWord( hash, static_cast<uint64_t>( smpop.getN() ) );
+   for ( int counter = 0; counter < smpop.getN(); ++counter ) {
+      const Population<Symbiont>& spop = smpop.getMetapop()[counter];
+      hash = hashWord( hash, spop.getID() );
+      hash = hashWord( hash, spop.getPatchID() );
+      hash = hashWord( hash, static_cast<uint64_t>( spop.getN() ) );
+      for ( int i = 0; i < spop.getN(); ++i ) {
+         const Symbiont symb = spop.getInd( i );
+         hash = hashWord( hash, static_cast<uint64_t>( symb.getSex() ) );
+         for ( int w = 0; w < ModelGenome::NWords; ++w ) { hash = hashWord( hash, ModelGenome::word( symb.getGen(), w ) ); }
+      }
+   }
+   return hash;
+}
+
+// ---Utility functions---
+
+string Golden::getFileName() {
+   std::string replid = std::to_string( Simul::getReplID() );
+   return ( "golden/golden" + Simul::getScenID() + "_" + replid + ".csv" );
+}
+
+uint64_t Golden::hashWord( uint64_t hash, uint64_t word ) {
+   for ( int byte = 0; byte < 8; ++byte ) {
+      hash ^= ( word >> ( 8 * byte ) ) & 0xFF;
+      hash *= FnvPrime;
+   }
+   return hash;
+}
+
+// ---Static data members---
+int Golden::Mode = ModeOff;
+bool Golden::StateHash = false;
+int Golden::NRows = 0;
+int Golden::NMismatches = 0;
+int Golden::FirstMismatch = -1;
+std::vector<uint64_t> Golden::GoldenRowHash;
+std::vector<uint64_t> Golden::GoldenStateHash;
+std::ofstream Golden::GoldenFile;
+
+// ---Constructor---
+
+Golden::Golden() {}
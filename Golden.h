@@ -0,0 +1,73 @@
+// Golden class definition
+
+/* Golden-output regression harness.
+   Every row printed into output1 is hashed (64-bit FNV-1a) and, optionally, the full state of the
+   host population and the symbiont metapopulation is hashed as well (sex, genotype, IDs and sizes
+   of every living individual and population, in storage order). The hashes are either recorded
+   into golden/golden<ScenID>_<ReplID>.csv or compared against that file, so that a run started
+   from a stored RNG state (RNG_internal_state/) can be proven to produce identical results.
+   Modes (optional JSON key "Golden"):
+      "off" = no hashing (default)
+      "record" = write the golden file
+      "verify" = compare against the golden file (the run fails if any hash differs)
+      "auto" = verify if the golden file exists, record otherwise
+*/
+
+#ifndef GOLDEN_H
+#define GOLDEN_H
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <string>
+#include <vector>
+#include <fstream>
+
+// Forward declarations:
+class Host;
+class Symbiont;
+template<typename T>
+class Population;
+template<typename T>
+class Metapopulation;
+
+class Golden {
+public:
+
+   enum Mode { ModeOff = 0, ModeRecord, ModeVerify, ModeAuto };
+
+   Golden(); // constructor
+
+   // Static member functions
+
+   static void setMode( const std::string& ); // Set Mode from its name ("off", "record", "verify" or "auto")
+   static int getMode(); // Get Mode
+
+   static void setStateHash( bool ); // Set StateHash
+   static bool getStateHash(); // Get StateHash
+
+   static void init(); // Open (record) or read (verify) the golden file
+   static void checkRow( const std::string&, const Population<Host>&, const Metapopulation<Population<Symbiont>>& ); // Hash one output row (and the state) and record or verify it
+   static bool finish(); // Close the golden file and report the result of the verification (false if it failed)
+
+   static uint64_t hashString( const std::string&, uint64_t = FnvOffset ); // FNV-1a hash of a string
+   static uint64_t hashState( const Population<Host>&, const Metapopulation<Population<Symbiont>>& ); // FNV-1a hash of the host and symbiont state
+
+private:
+
+   static const uint64_t FnvOffset = 0xcbf29ce484222325ULL; // FNV-1a offset basis
+   static const uint64_t FnvPrime = 0x100000001b3ULL; // FNV-1a prime
+
+   static int Mode; // Current mode
+   static bool StateHash; // Whether the full host/symbiont state is hashed too
+   static int NRows; // Number of rows checked
+   static int NMismatches; // Number of rows whose hashes differ from the golden file
+   static int FirstMismatch; // Index of the first row that differs (-1 if none)
+   static std::vector<uint64_t> GoldenRowHash; // Row hashes read from the golden file
+   static std::vector<uint64_t> GoldenStateHash; // State hashes read from the golden file
+   static std::ofstream GoldenFile; // Golden file (record mode)
+
+   // Utility functions
+   static std::string getFileName(); // Get the path of the golden file
+   static uint64_t hashWord( uint64_t, uint64_t ); // Add a 64-bit word to a FNV-1a hash
+   };
+
+   #endif // GOLDEN_H
@@ -11,6 +11,22 @@
 using namespace std;
 
 // ---Static member functions---
+double Host::meanNGametes( double phen, int nsymbiont, const Patch& island, int n ) {
+   // Getting data from hpop and Patch
+   double N = static_cast<double>(n);
+   double K = static_cast<double>( island.getKhost() );
+   double OptPhen = island.getOptPhen();
+   // Calculation of the expected mean number of gamete produced
+      double term1 = Rmax * ( 1 - N / K );
+      double term2 = ( phen - OptPhen ) * ( phen - OptPhen );
+      double term3 = Vs + Vs;
+      double term4 = lambda * ( Ksymbiont / ( 1 + Ksymbiont * exp ( -b * nsymbiont ) ) );
+      double R = term1 -  term2 / term3 + term4 ;
+      // Expected number of gametes
+      double mean = (exp(R) + exp(R)) * d;
+   return ( mean );
+}
+
 int Host::getKsymbiont() {return Ksymbiont;}
 void Host::setKsymbiont( int ks ) { Ksymbiont = ks; }
 double Host::getRmax() {return Rmax;}
@@ -36,7 +52,7 @@ double Host::d = Param::getd();
 double Host::mutRate = Param::getmutRateH();
 
 // constructor
-Host::Host(char sx, uint64_t gn, double ph, int Ns, uint64_t id, uint64_t spopid)
+Host::Host(char sx, const ModelGenome::Gen& gn, double ph, int Ns, uint64_t id, uint64_t spopid)
    : Organism (sx, gn, ph) {
    setNsymbiont(Ns);
    setID(id);
@@ -143,27 +159,16 @@ string Host::toString() const {
 
 HostGamete Host::createOneGamete() const {
    HostGamete gamete;
-   int32_t hplgen = createOneHaplGen();
+   ModelGenome::Hapl hplgen = createOneHaplGen();
    gamete.setHaplGen( hplgen );
    gamete.setHostID( getID() );
    return(gamete);
 }
 
 int Host::calculateNGametes(const Patch& island, int n, Rng& rng) const {
-   // Getting data from hpop and Patch
-   double N = static_cast<double>(n);
-   double K = static_cast<double>( island.getKhost() );
-   double OptPhen = island.getOptPhen();
-   // Calculation of the expected mean number of gamete produced
-      double term1 = Rmax * ( 1 - N / K );
-      double term2 = ( getPhen() - OptPhen ) * ( getPhen() - OptPhen );
-      double term3 = Vs + Vs;
-      double term4 = lambda * ( Ksymbiont / ( 1 + Ksymbiont * exp ( -b * Nsymbiont ) ) );
-      double R = term1 -  term2 / term3 + term4 ;
-      // Sampling number of gametes
-      double mean = (exp(R) + exp(R)) * d;
+   // Sampling number of gametes
+   double mean = meanNGametes( getPhen(), Nsymbiont, island, n );
 //cout << "\nmean = " << mean;
-//cout << "\nterm1 = " << term1;
 return ( rng.poisson(mean) );
 }
 
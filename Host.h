@@ -14,7 +14,7 @@ class Host : public Organism {
 
 public:
 
-   explicit Host (char = '\0', uint64_t = 0, double = 0, int = 0, uint64_t = 0, uint64_t = 0); // constructor
+   explicit Host (char = '\0', const ModelGenome::Gen& = ModelGenome::Gen(), double = 0, int = 0, uint64_t = 0, uint64_t = 0); // constructor
 
    void setNsymbiont(int); // Set number of symbionts inhabiting the host
    int getNsymbiont() const; // Get sex ("m" for male, : "f" for male)
@@ -39,6 +39,7 @@ public:
 
    // Static member functions (they cannot be declared as constant!)
 
+   static double meanNGametes( double, int, const Patch&, int ); // Expected number of gametes of a host. Parameters: its phenotype and number of symbionts, its patch and the size of its population
    static int getKsymbiont(); // Get Ksymbiont
    static void setKsymbiont( int ); // Set Ksymbiont
    static double getRmax(); // Get Rmax
@@ -11,7 +11,7 @@
 using namespace std;
 
 // constructor
-HostGamete::HostGamete(uint32_t hgen, uint64_t hid): Gamete (hgen) {
+HostGamete::HostGamete(const ModelGenome::Hapl& hgen, uint64_t hid): Gamete (hgen) {
    setHostID(hid);
 }
 
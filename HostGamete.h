@@ -9,7 +9,7 @@
 
 class HostGamete : public Gamete  {
 public:
-   explicit HostGamete(uint32_t = 0, uint64_t = 0);
+   explicit HostGamete(const ModelGenome::Hapl& = ModelGenome::Hapl(), uint64_t = 0);
 
    void setHostID(uint64_t);
    uint64_t getHostID() const;
@@ -0,0 +1,82 @@
+// Implementation of LinkageMap class
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <cmath>
+#include <vector> // C++ standard vector class template
+#include "LinkageMap.h"
+#include "Rng.h"
+
+using namespace std;
+
+// ---Static member functions---
+
+void LinkageMap::setDistances( const vector<double>& distances ) {
+   Active = !distances.empty();
+   CountCdf.clear();
+   IntervalCdf.clear();
+   Guide.clear();
+   Suffix.clear();
+   if ( !Active ) { return; }
+   const int nintervals = static_cast<int>( distances.size() );
+   double length = 0; // total map length D (Morgans)
+   for ( double d : distances ) { length += d; }
+   // Interval of a crossover: cumulative map position, scaled to 2^32 (the last one ends at 2^32)
+   const double scale32 = 4294967296.0;
+   double position = 0;
+   for ( int i = 0; i < nintervals; ++i ) {
+      position += distances[i];
+      IntervalCdf.push_back( ( i == nintervals - 1 || length == 0 ) ? static_cast<uint64_t>( scale32 ) : static_cast<uint64_t>( position / length * scale32 ) );
+      Suffix.push_back( ModelGenome::lociFrom( i + 1 ) );
+   }
+   AllLoci = ModelGenome::lociFrom( 0 );
+   // Guide table: first interval that may hold a position, for each value of its upper GuideBits bits
+   GuideBits = 8;
+   while ( ( 1 << GuideBits ) < 4 * nintervals && GuideBits < 16 ) { ++GuideBits; }
+   Guide.assign( static_cast<size_t>( 1 ) << GuideBits, 0 );
+   for ( size_t g = 0, interval = 0; g < Guide.size(); ++g ) {
+      uint64_t start = static_cast<uint64_t>( g ) << ( 32 - GuideBits );
+      while ( IntervalCdf[ interval ] <= start ) { ++interval; }
+      Guide[g] = static_cast<int>( interval );
+   }
+   // Number of crossovers: Poisson cumulative distribution up to a tail below 2^-31 (the last entry is 2^31)
+   const double scale31 = 2147483648.0;
+   const int nmax = static_cast<int>( length + 12 * sqrt( length ) ) + 16;
+   double cdf = 0;
+   for ( int n = 0; n < nmax; ++n ) {
+      cdf += ( length > 0 ) ? exp( -length + n * log( length ) - lgamma( n + 1.0 ) ) : ( n == 0 ? 1 : 0 );
+      if ( cdf >= 1 - 1 / scale31 ) { break; }
+      CountCdf.push_back( static_cast<uint64_t>( cdf * scale31 ) );
+   }
+   CountCdf.push_back( static_cast<uint64_t>( scale31 ) );
+}
+
+bool LinkageMap::getActive() {return Active;}
+
+ModelGenome::Hapl LinkageMap::recombine( const ModelGenome::Gen& gen ) {
+   uint32_t u = randomWord();
+   // Starting haplotype from the lowest bit, number of crossovers from the other 31 bits
+   ModelGenome::Hapl mask = ( u & 1 ) ? AllLoci : ModelGenome::Hapl();
+   int ncrossovers = 0;
+   for ( uint64_t x = u >> 1; x >= CountCdf[ ncrossovers ]; ) { ++ncrossovers; } // sequential search from 0 (about D steps)
+   for ( int c = 0; c < ncrossovers; ++c ) {
+      uint64_t x = randomWord();
+      int interval = Guide[ x >> ( 32 - GuideBits ) ];
+      while ( x >= IntervalCdf[ interval ] ) { ++interval; }
+      ModelGenome::xorHapl( mask, Suffix[ interval ] ); // switch haplotype after the crossover
+   }
+   return( ModelGenome::selectAlleles( gen, mask ) );
+}
+
+// ---Utility functions---
+
+uint32_t LinkageMap::randomWord() { return( Rng::getLegacy() ? Rng::random_uint32() : Rng::random_bits32() ); }
+
+// ---Static data members---
+
+bool LinkageMap::Active = false;
+vector<uint64_t> LinkageMap::CountCdf;
+vector<uint64_t> LinkageMap::IntervalCdf;
+vector<int> LinkageMap::Guide;
+int LinkageMap::GuideBits = 8;
+vector<ModelGenome::Hapl> LinkageMap::Suffix;
+ModelGenome::Hapl LinkageMap::AllLoci = ModelGenome::Hapl();
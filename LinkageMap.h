@@ -0,0 +1,45 @@
+// LinkageMap class definition
+
+/* Recombination of linked loci along a genetic map (optional JSON key "LinkageMap": the L-1 map distances,
+   in Morgans, between adjacent loci), replacing free recombination (Genome::recombine) when it is set.
+   Crossovers follow the Haldane map function: their number is Poisson with mean the total map length D,
+   and each is placed uniformly along the map, i.e. in the interval between loci i and i+1 with probability
+   d_i / D. A gamete starts on a random parental haplotype and switches haplotype at each crossover, so its
+   selection mask is the XOR of the precomputed masks of the loci after each crossover (Suffix) and the
+   gamete is built with the same XOR/AND sequence as free recombination (Genome::selectAlleles).
+   A gamete costs one random word (number of crossovers and starting haplotype) plus one per crossover,
+   located in the cumulative map from a guide table (usually without any search).
+*/
+
+#ifndef LINKAGEMAP_H
+#define LINKAGEMAP_H
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <vector> // C++ standard vector class template
+#include "Genome.h" // ModelGenome (genotype storage chosen at compile time)
+
+class LinkageMap {
+public:
+
+   // Static member functions
+
+   static void setDistances( const std::vector<double>& ); // Build the crossover tables from the map distances between adjacent loci (an empty vector deactivates them)
+   static bool getActive(); // Whether the gametes are produced by linked recombination
+   static ModelGenome::Hapl recombine( const ModelGenome::Gen& ); // Haploid genotype of a gamete by linked recombination
+
+private:
+
+   // Static data
+   static bool Active; // Whether the gametes are produced by linked recombination
+   static std::vector<uint64_t> CountCdf; // Poisson cumulative distribution of the number of crossovers, scaled to 2^31
+   static std::vector<uint64_t> IntervalCdf; // Cumulative map position of the end of each interval, scaled to 2^32
+   static std::vector<int> Guide; // First interval of the positions with each value of their upper GuideBits bits
+   static int GuideBits; // Number of bits indexing Guide
+   static std::vector<ModelGenome::Hapl> Suffix; // Mask of the loci after each interval
+   static ModelGenome::Hapl AllLoci; // Mask of all the loci (the gamete starts on haplotype 1)
+
+   // Utility functions
+   static uint32_t randomWord(); // Random 32-bit word (the engine in legacy mode, the bit buffer otherwise)
+   };
+
+   #endif // LINKAGEMAP_H
@@ -0,0 +1,64 @@
+// Implementation of LocusEffects class
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <vector> // C++ standard vector class template
+#include "LocusEffects.h"
+
+using namespace std;
+
+// ---Static member functions---
+
+void LocusEffects::setEffects( const vector<double>& effects ) {
+   Active = !effects.empty();
+   Base = 0;
+   Lut.clear();
+   ActiveBytes.clear();
+   if ( !Active ) { return; }
+   const int nloci = static_cast<int>( effects.size() );
+   const int nbits = 64 * ModelGenome::NWords;
+   // Effect of each bit of the genotype words (zero for the bits outside the L loci)
+   vector<double> biteffect( nbits, 0 );
+   for ( int bit = 0; bit < nbits; ++bit ) {
+      int locus = ModelGenome::locusOfBit( bit );
+      if ( locus < nloci ) {
+         biteffect[ bit ] = effects[ locus ];
+         Base -= effects[ locus ];
+      }
+   }
+   // One table of 256 sums per byte, for the bytes that hold some locus
+   Lut.assign( 256 * nbits / 8, 0 );
+   for ( int j = 0; j < nbits / 8; ++j ) {
+      bool used = false;
+      for ( int b = 0; b < 8; ++b ) { used = used || biteffect[ 8 * j + b ] != 0; }
+      if ( !used ) { continue; }
+      ActiveBytes.push_back( j );
+      for ( int value = 0; value < 256; ++value ) {
+         double sum = 0;
+         for ( int b = 0; b < 8; ++b ) {
+            if ( value & ( 1 << b ) ) { sum += 2 * biteffect[ 8 * j + b ]; }
+         }
+         Lut[ 256 * j + value ] = sum;
+      }
+   }
+}
+
+bool LocusEffects::getActive() {return Active;}
+
+void LocusEffects::phenotypes( const ModelGenome::Gen* gens, size_t n, double* phen ) {
+   for ( size_t i = 0; i < n; ++i ) { phen[i] = Base; }
+   for ( int j : ActiveBytes ) { // one table at a time over the whole batch
+      const double* lut = &Lut[ 256 * j ];
+      const int w = j / 8;
+      const int shift = 8 * ( j % 8 );
+      for ( size_t i = 0; i < n; ++i ) {
+         phen[i] += lut[ ( ModelGenome::word( gens[i], w ) >> shift ) & 0xFF ];
+      }
+   }
+}
+
+// ---Static data members---
+
+bool LocusEffects::Active = false;
+double LocusEffects::Base = 0;
+vector<double> LocusEffects::Lut;
+vector<int> LocusEffects::ActiveBytes;
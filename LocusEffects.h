@@ -0,0 +1,49 @@
+// LocusEffects class definition
+
+/* Genotype-to-phenotype map with a different effect size per locus (optional JSON key "LocusEffects":
+   one value per locus). As with a single effect size Alpha, each allele "1" of locus k adds effect[k] to
+   the phenotype and each allele "0" subtracts it:
+      Phen = Base + sum over the alleles "1" of 2 effect[k],   Base = - sum over the 2L alleles of effect[k]
+   The genotype words are read byte by byte: a lookup table per byte of the genotype holds the sum of
+   2 effect[k] over the alleles "1" of each of the 256 values of that byte, so a phenotype costs one
+   addition per byte (8 per 64-bit word) instead of one per locus. Bytes that only hold bits outside the
+   L loci are skipped. A batch of genotypes is evaluated one byte at a time over the whole batch, so that
+   each table stays in cache and the inner loop (a table lookup and an addition per genotype) can be
+   vectorised; batch and single evaluations add the same terms in the same order and give the same values.
+   Without the key, Organism keeps the phenotype table of a single effect size (PhenTable, one lookup).
+*/
+
+#ifndef LOCUSEFFECTS_H
+#define LOCUSEFFECTS_H
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <cstddef> // size_t type
+#include <vector> // C++ standard vector class template
+#include "Genome.h" // ModelGenome (genotype storage chosen at compile time)
+
+class LocusEffects {
+public:
+
+   // Static member functions
+
+   static void setEffects( const std::vector<double>& ); // Build the byte tables from the effect sizes of the L loci (an empty vector deactivates them)
+   static bool getActive(); // Whether the phenotypes use the per-locus effect sizes
+
+   // Phenotype of a genotype
+   static double phenotype( const ModelGenome::Gen& gen ) {
+      double phen = Base;
+      for ( int j : ActiveBytes ) { phen += Lut[ 256 * j + ( ( ModelGenome::word( gen, j / 8 ) >> ( 8 * ( j % 8 ) ) ) & 0xFF ) ]; }
+      return( phen );
+   }
+   static void phenotypes( const ModelGenome::Gen*, size_t, double* ); // Phenotypes of an array of genotypes. Parameters: pointer to the genotypes, number of genotypes and pointer to the phenotypes
+
+private:
+
+   // Static data
+   static bool Active; // Whether the phenotypes use the per-locus effect sizes
+   static double Base; // Phenotype of the genotype with only alleles "0"
+   static std::vector<double> Lut; // Sum of 2 effect[k] over the 1-bits of each value (256 per byte of the genotype)
+   static std::vector<int> ActiveBytes; // Bytes of the genotype that hold bits of the L loci
+   };
+
+   #endif // LOCUSEFFECTS_H
@@ -151,6 +151,7 @@ template<typename T> // Function to create an empty symbiont population from a n
 template<typename T> // Overloaded function for symbiont metapopulations
    void Metapopulation<T>::metapopReproduction( Population<Host>& hpop, Rng& rng) {
    for ( int counter = 0; counter < N; ++counter ) { // For each population
+   Rng::setEntity( Metapop[counter].getPatchID() & 0xFFFFFFFF ); // substream of the host (stream mode)
    Metapop[counter].popReproduction ( hpop, rng );
    } // End for each population
 }
@@ -220,19 +221,11 @@ void Metapopulation<T>::horizTrans( Rng& rng, Population<Host>& hpop) {
 //std::cout << "\n\tDestination population index: " << indexDestPop;
 //std::cout << "\n\tNew immigrant index: " << indexNewIm;
                // Swap data between target locations of the source and destination vectors
-               Symbiont* ptrSrcLoc = Metapop[indexSrcPop].getPtrToInd( indexEmigrant );
-               Symbiont* ptrDestLoc = Metapop[indexDestPop].getPtrToInd( indexNewIm );
-               std::swap(
-                  *(ptrSrcLoc), // Source
-                  *(ptrDestLoc) // Destination
-               );
+               Metapop[indexSrcPop].swapInd( indexEmigrant, Metapop[indexDestPop], indexNewIm );
                // Remove emigrant from the source population:
                Metapop[indexSrcPop].removeInd( hpop, indexEmigrant );
                // Update size of the source population (n)
                n = Metapop[indexSrcPop].getN();
-               // Set pointers to null:
-               ptrSrcLoc = nullptr;
-               ptrDestLoc = nullptr;
             } // End for each emigrant in a population
          }  // End if the population is not empty
       } // End for each population
@@ -244,11 +237,10 @@ void Metapopulation<T>::verTrans( Rng& rng, Population<Host>& hpop, int64_t nbSp
    // Get emigration rate
    double e = Symbiont::getEvt();
    // Get host parent and symbiont populations involved
-   Host* ParentPtr = hpop.getInd(parent_id);
    Population<Symbiont>* nbSpopPtr = getPop( nbSpop_id );
-   Population<Symbiont>* pSpopPtr = getPop( ParentPtr->getSPopID() );
+   Population<Symbiont>* pSpopPtr = getPop( hpop.getSPopID( parent_id ) );
 //std::cout << "\nParent\n";
-//ParentPtr->printIndividual();
+//hpop.getInd( parent_id ).printIndividual();
 //printiList();
 //printMetapopulation();
 //printPopulations();
@@ -256,8 +248,6 @@ void Metapopulation<T>::verTrans( Rng& rng, Population<Host>& hpop, int64_t nbSp
 //nbSpopPtr->printPopulation();
 //std::cout << "\nSPopP\n";
 //pSpopPtr->printPopulation();
-   // Set pointers to null:
-   ParentPtr = nullptr;
    if (pSpopPtr->getN() > 0) { // if the parent harbours symbionts
       // Determine number of emigrants from the parent to the newborn
       int Nemigrants = rng.binomial( pSpopPtr->getN(), e);
@@ -273,17 +263,9 @@ void Metapopulation<T>::verTrans( Rng& rng, Population<Host>& hpop, int64_t nbSp
             // Create a new immigrant in the population of destination (i.e. newborn)
             int indexNewIm = nbSpopPtr->newImmigrant( hpop );
             // Swap data between target locations of the source and destination vectors
-            Symbiont* ptrSrcLoc = pSpopPtr->getPtrToInd( indexEmigrant );
-            Symbiont* ptrDestLoc = nbSpopPtr->getPtrToInd( indexNewIm );
-            std::swap(
-               *(ptrSrcLoc), // Source
-               *(ptrDestLoc) // Destination
-            );
+            pSpopPtr->swapInd( indexEmigrant, *nbSpopPtr, indexNewIm );
             // Remove emigrant from the source population:
             pSpopPtr->removeInd( hpop, indexEmigrant );
-            // Set pointers to null:
-            ptrSrcLoc = nullptr;
-            ptrDestLoc = nullptr;
          } // End for each emigrant in the parent's population
       } // End if we have immigrants
    }  // End if the parent harbours symbionts
@@ -406,9 +388,7 @@ double Metapopulation<T>::getHSPhenCor( Population<Host>& hpop ) const {
    for ( int counter = 0; counter < N; ++counter ) {
       if ( Metapop[counter].getN() > 0 ) {
          sphen.push_back(Metapop[counter].getAvSPhen());
-         Host* ptrHost = hpop.getInd ( Metapop[counter].getPatchID() );
-         hphen.push_back(ptrHost->getPhen());
-         ptrHost = nullptr;
+         hphen.push_back( hpop.getPhen( Metapop[counter].getPatchID() ) );
          ++NHocc;
       }
    }
@@ -432,9 +412,11 @@ template<typename T>
 std::vector<int> Metapopulation<T>::getAlFreq() const {
    std::vector<int> alfreq( Symbiont::getL() );
    if (N>0) {
+      ModelGenome::Counter alleles; // one pass over the whole metapopulation
       for ( int counter = 0; counter < N ; ++counter ) {
-         Metapop[counter].getAlFreq( alfreq );
+         Metapop[counter].addAlleles( alleles );
       }
+      alleles.addTo( alfreq );
    }
    return( alfreq );
 }
@@ -444,10 +426,12 @@ double Metapopulation<T>::getHexp() const {
    std::vector<int> nal1( Symbiont::getL() );
    int ntotal = 0;
    if (N>0) {
+      ModelGenome::Counter alleles; // one pass over the whole metapopulation
       for ( int counter = 0; counter < N ; ++counter ) {
-         Metapop[counter].getAlFreq( nal1 );
+         Metapop[counter].addAlleles( alleles );
          ntotal += Metapop[counter].getN();
       }
+      alleles.addTo( nal1 );
    }
    double numerator_Hexp = 0;
    double nal = static_cast<double>(ntotal) * 2; // nal is the total number of alleles per locus in the
@@ -511,12 +495,12 @@ uint64_t Metapopulation<T>::createPop( Population<Host>& hpop, uint64_t hostid )
       freeList.pop();
       // Initialize PatchID with the host ID
       Metapop[N].setPatchID( hostid );
+      // A new population: its genotype classes have not been checked yet
+      Metapop[N].resetClassCheck();
       // Set ID of the new symbiont population
       Metapop[N].setID (static_cast<uint64_t>(newID) | ((( Metapop[N].getID() >> 32 ) + 1 ) << 32)); // set the ID's lower32 part (ie. the index) equal to newID, and increment by 1 the upper32 part (i.e. the version)
       // Update Host.SPopID
-      Host* ptrHost = hpop.getInd ( hostid ); // hpop is the name of the host population
-      ptrHost->setSPopID(Metapop[N].getID());
-      ptrHost = nullptr;
+      hpop.setSPopID( hostid, Metapop[N].getID() ); // hpop is the name of the host population
       uint64_t newID64 = Metapop[N].getID();
       indList[newID] = N;
 //std::cout << "\n\nSMetapoplist after new Spop born\n";
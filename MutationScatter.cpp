@@ -0,0 +1,48 @@
+// Implementation of MutationScatter class
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <cmath>
+#include "MutationScatter.h"
+#include "Rng.h"
+
+using namespace std;
+
+// ---Member functions---
+
+uint64_t MutationScatter::nextMask( int nal, Rng& rng ) {
+   if ( Next < 0 ) { Next = skip( rng ); } // first mutated site of the event
+   const int64_t end = Base + nal;
+   uint64_t mask = 0;
+   while ( Next < end ) {
+      mask |= 1ULL << ( Next - Base );
+      Next += 1 + skip( rng );
+   }
+   Base = end;
+   return mask;
+}
+
+int MutationScatter::nextAllele( int nal, Rng& rng ) {
+   if ( Next < 0 ) { Next = skip( rng ); } // first mutated site of the event
+   const int64_t end = Base + nal;
+   if ( Next < end ) {
+      int allele = static_cast<int>( Next - Base );
+      Next += 1 + skip( rng );
+      return allele;
+   }
+   Base = end;
+   return -1;
+}
+
+// ---Utility functions---
+
+int64_t MutationScatter::skip( Rng& rng ) {
+   if ( Rate <= 0 ) { return INT64_MAX / 2; } // no mutation
+   if ( Rate >= 1 ) { return 0; } // every site mutates
+   // Geometric number of failures before the first success: floor( log(U) / log(1 - Rate) ), with U in (0,1]
+   double nskip = floor( log( 1 - rng.unif_01() ) / LogQ );
+   return ( ( nskip < 1e18 ) ? static_cast<int64_t>( nskip ) : INT64_MAX / 2 );
+}
+
+// ---Constructor---
+
+MutationScatter::MutationScatter( double rate ): Rate(rate), LogQ( ( rate > 0 && rate < 1 ) ? log1p( -rate ) : 0 ), Next(-1), Base(0) {}
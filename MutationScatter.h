@@ -0,0 +1,39 @@
+// MutationScatter class definition
+
+/* Mutations of all the newborns of a reproductive event.
+   Each allele of each newborn mutates independently with probability mutRate. Instead of sampling
+   the number of mutations of every newborn and shuffling its alleles, the (newborn, allele) sites of
+   the whole event are seen as one sequence, and the next mutated site is found by a geometric skip
+   over the sites that do not mutate (one uniform draw per mutation, none per newborn).
+   The newborns take their masks of mutated alleles in the order in which they are created:
+      MutationScatter mutations( mutRate );
+      for each newborn: gen ^= mutations.nextMask( nal, rng );
+   or, for more than 64 alleles per newborn (see Genome):
+      for each newborn: while ( ( allele = mutations.nextAllele( nal, rng ) ) >= 0 ) { flip allele }
+*/
+
+#ifndef MUTATIONSCATTER_H
+#define MUTATIONSCATTER_H
+
+#include <cstdint> // uint32_t and uint64_t types
+#include "Rng.h"
+
+class MutationScatter {
+public:
+
+   explicit MutationScatter( double ); // constructor (parameter: per-allele mutation rate)
+
+   uint64_t nextMask( int, Rng& ); // Get the mask of the mutated alleles of the next newborn (parameter: number of alleles, at most 64)
+   int nextAllele( int, Rng& ); // Get the next mutated allele of the current newborn, or -1 if there is none left (the next call then starts the next newborn). Parameter: number of alleles
+
+private:
+   double Rate; // Per-allele mutation rate
+   double LogQ; // log( 1 - Rate )
+   int64_t Next; // Next mutated site (-1 if not sampled yet)
+   int64_t Base; // First site of the next newborn
+
+   // Utility functions
+   int64_t skip( Rng& ); // Sample the number of sites without mutation before the next mutated site
+   };
+
+   #endif // MUTATIONSCATTER_H
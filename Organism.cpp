@@ -8,11 +8,23 @@
 #include <iostream>
 #include <sstream>
 #include "Organism.h"
+#include "PhenTable.h"
+#include "LocusEffects.h"
+#include "LinkageMap.h"
 #include "Rng.h"
 #include "Param.h"
 
 using namespace std;
 
+// Genetic architecture fixed at compile time (e.g. -DFIXED_ALPHA=0.15625 -DFIXED_L=32): the phenotype
+// table is computed by the compiler and indexed directly, and the input parameters must match it
+#ifdef FIXED_ALPHA
+#ifndef FIXED_L
+#define FIXED_L ModelGenome::MaxL
+#endif
+static constexpr PhenTable::Fixed<ModelGenome::nAlleles( FIXED_L )> FixedPhenotypes( FIXED_ALPHA );
+#endif
+
 // ---Static member functions---
 
 int Organism::getL() {return L;}
@@ -21,13 +33,58 @@ void Organism::setL( int l ) { L = l; }
 double Organism::getAlpha() {return Alpha;}
 void Organism::setAlpha( double alpha ) { Alpha = alpha; }
 
+void Organism::initPhenTable() {
+   // The table computed at compile time (checked against the input parameters), or computed for the input parameters
+#ifdef FIXED_ALPHA
+   if ( L != FIXED_L || Alpha != FIXED_ALPHA ) {
+      cerr << "Error: this build has a genetic architecture fixed at compile time (Alpha = " << FIXED_ALPHA << ", L = " << FIXED_L
+         << "), but the input has Alpha = " << Alpha << " and L = " << L << " (compile without -DFIXED_ALPHA for any architecture)" << endl;
+      exit(1);
+   }
+   Phenotypes = FixedPhenotypes.data();
+#else
+   int nal = ModelGenome::nAlleles( L );
+   RuntimePhenotypes.assign( nal + 1, 0 );
+   PhenTable::fill( RuntimePhenotypes.data(), nal, Alpha );
+   Phenotypes = RuntimePhenotypes.data();
+#endif
+}
+
+bool Organism::getFixedPhenTable() {
+#ifdef FIXED_ALPHA
+   return( true );
+#else
+   return( false );
+#endif
+}
+
+double Organism::phenotype( const ModelGenome::Gen& gen ) {
+   if (LocusEffects::getActive()) { return (LocusEffects::phenotype(gen)); } // effect sizes per locus
+#ifdef FIXED_ALPHA
+   return (FixedPhenotypes[ModelGenome::countOnes(gen)]); // table computed at compile time
+#else
+   return (Phenotypes[ModelGenome::countOnes(gen)]); // (Nbites1 times Alpha) - (Nbites0 times Alpha), see PhenTable
+#endif
+}
+
+ModelGenome::Hapl Organism::createHaplGen( const ModelGenome::Gen& gen ) {
+   if (LinkageMap::getActive()) { return (LinkageMap::recombine(gen)); } // recombination along the linkage map
+   return (ModelGenome::recombine(gen)); // free recombination
+}
+
+int64_t Organism::sumHetLoc( const ModelGenome::Gen* gens, size_t n ) {
+   return( ModelGenome::sumHet( gens, n ) );
+}
+
 // ---Static data members---
 
 int Organism::L = Param::getL();
 double Organism::Alpha = Param::getAlpha();
+const double* Organism::Phenotypes = nullptr;
+vector<double> Organism::RuntimePhenotypes;
 
 // constructor
-Organism::Organism(char sx, uint64_t gn, double ph): Sex(sx), Gen(gn), Phen(ph) {}
+Organism::Organism(char sx, const ModelGenome::Gen& gn, double ph): Sex(sx), Gen(gn), Phen(ph) {}
 
 // ---Non-static member functions---
 
@@ -35,81 +92,47 @@ void Organism::setSex(char sx) {Sex = sx;}
 char Organism::getSex() const {return Sex;}
 
 
-void Organism::setGen(uint64_t gn) {Gen = gn;}
-uint64_t Organism::getGen() const {return Gen;}
+void Organism::setGen(const ModelGenome::Gen& gn) {Gen = gn;}
+const ModelGenome::Gen& Organism::getGen() const {return Gen;}
 
 
 void Organism::setPhen(double ph) {Phen = ph;}
 double Organism::getPhen() const {return Phen;}
 
 void Organism::Phen_init() {
-   int Nbites1 = popcount64b(Gen);
-   int Nbites0 = 64 - Nbites1;
-   double phen = sumAlpha(Nbites1) - sumAlpha(Nbites0);
-   setPhen(phen);
+   setPhen(phenotype(Gen));
 }
 
 void Organism::printGen() const {
-   auto pairGen{pair32Int(Gen)};
    cout << "Individual genotype: " << endl;
-   displayBits(pairGen.first);
-   displayBits(pairGen.second);
+   for (int h = 0; h < 2; ++h) { // lower, then upper haplotype
+      ModelGenome::Hapl hapl = ModelGenome::haplotype(Gen, h);
+      for (int w = 0; w < ModelGenome::HaplWords32; ++w) { displayBits(ModelGenome::word32(hapl, w)); }
+   }
 }
 
 string Organism::toString() const {
    ostringstream output;
    output << fixed << setprecision(2);
    output << "Gender: " << getSex()
-      << "\nGenotype: " << std::bitset<64>(getGen())
+      << "\nGenotype: " << ModelGenome::toString(getGen())
       << "\nPhenotype = " << getPhen()
       << "\nL = " << getL()
       << "\nAlpha = " << getAlpha();
    return output.str();
 }
 
-uint32_t Organism::createOneHaplGen() const {
-   pair<uint32_t, uint32_t> Hplgens = pair32Int(Gen);
-   return (freeRecombination(Hplgens.first,Hplgens.second));
+ModelGenome::Hapl Organism::createOneHaplGen() const {
+   return (createHaplGen(Gen));
 }
 
 int Organism::sumHetLocInd () const {
-   pair<uint32_t, uint32_t> Hplgens = pair32Int(Gen);
-   const uint32_t SHIFT{8 * sizeof(uint32_t) - 1};
-   const uint32_t MASK{static_cast<const uint32_t>(1 << SHIFT)};
-
-   int NLocHet = 0; // NLocHet is the number of heterozigotic loci
-
-   for (uint32_t i{1}; i <= SHIFT + 1; ++i) { // for each locus
-      // sum the two allele values of the locus
-      int sumAlLoc = (Hplgens.first & MASK ? 1 : 0) + (Hplgens.second & MASK ? 1 : 0);
-
-      if (sumAlLoc == 1) { // If the locus is heterozigotic
-         ++NLocHet;
-      }
-     Hplgens.first <<= 1; // shift value left by 1
-     Hplgens.second <<= 1; // shift value left by 1
-   }
-   return(NLocHet);
+   // A locus is heterozigotic if its two alleles differ, i.e. if its bit is 1 in the XOR of both haplotypes
+   return( ModelGenome::countHet( Gen ) );
 }
 
 // ---Utility functions---
 
-int Organism::popcount64b(uint64_t x) const {
-   x -= (x >> 1) & 0x5555555555555555;             //put count of each 2 bits into those 2 bits
-   x = (x & 0x3333333333333333) + ((x >> 2) & 0x3333333333333333); //put count of each 4 bits into those 4 bits
-   x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0f;        //put count of each 8 bits into those 8 bits
-   x += x >>  8;  //put count of each 16 bits into their lowest 8 bits
-   x += x >> 16;  //put count of each 32 bits into their lowest 8 bits
-   x += x >> 32;  //put count of each 64 bits into their lowest 8 bits
-   return x & 0x7f;
-}
-
-double Organism::sumAlpha(int nbites) const {
-   double alphaSum = 0;
-   for (int i = 1; i <= nbites; ++i) { alphaSum += Alpha; }
-   return(alphaSum);
-}
-
 void Organism::displayBits(uint32_t value) const {
    const uint32_t SHIFT{8 * sizeof(uint32_t) - 1};
    const uint32_t MASK{static_cast<const uint32_t>(1 << SHIFT)};
@@ -133,16 +156,4 @@ pair<uint32_t, uint32_t> Organism::pair32Int (uint64_t value) const {
     return pair<uint32_t, uint32_t>((value << 32) >> 32, value >> 32);
 }
 
-uint32_t Organism::freeRecombination(uint32_t Hplgen1,uint32_t Hplgen2) const {
-   uint32_t Randuint32 = Rng::random_uint32();
-   // Step 1
-   uint32_t A = Hplgen1 ^ Hplgen2;
-   // Step2
-   uint32_t B = Hplgen1 | A;
-   // Step3
-   uint32_t C = ( A & ( Randuint32 ^ 0xFFFFFFFF ) );
-   // Step4
-   uint32_t result = B ^ C;
-   return(result);
-}
 
@@ -5,18 +5,21 @@
 
 #include <cstdint> // uint32_t and uint64_t types
 #include <string>
+#include <cstddef> // size_t type
+#include <vector> // C++ standard vector class template
+#include "Genome.h" // ModelGenome (genotype storage chosen at compile time)
 
 class Organism {
 
 public:
 
-   explicit Organism(char = '\0', uint64_t = 0, double = 0); // constructor
+   explicit Organism(char = '\0', const ModelGenome::Gen& = ModelGenome::Gen(), double = 0); // constructor
 
    void setSex(char); // Set sex (i.e., gender: "m" for male, : "f" for male)
    char getSex() const; // Get sex ("m" for male, : "f" for male)
 
-   void setGen(uint64_t); // Set genotype
-   uint64_t getGen() const; // Get genotype
+   void setGen(const ModelGenome::Gen&); // Set genotype
+   const ModelGenome::Gen& getGen() const; // Get genotype
 
    void setPhen(double); // Set phenotype value
    double getPhen() const; // Get phenotype value
@@ -25,7 +28,7 @@ public:
    void printGen() const; // Print genotype
    std::string toString() const; // Get string representation of the object data members
 
-   uint32_t createOneHaplGen() const; // Creates a new haploid genotip by free recombination
+   ModelGenome::Hapl createOneHaplGen() const; // Creates a new haploid genotip by free recombination (or along the linkage map, see LinkageMap)
    
    int sumHetLocInd () const; // calculates the sum of the heterozigotic loci of the individual
 
@@ -35,23 +38,27 @@ public:
    static void setL( int ); // Set number of bi-allelic loci per genotype
    static double getAlpha(); // Get effect size for each allele
    static void setAlpha( double ); // Set effect size for each allele
+   static void initPhenTable(); // Tabulate the phenotype per number of alleles "1" (after setL and setAlpha)
+   static bool getFixedPhenTable(); // Whether the build uses the table computed at compile time (-DFIXED_ALPHA)
+   static double phenotype( const ModelGenome::Gen& ); // Phenotype of a genotype (see Phen_init)
+   static ModelGenome::Hapl createHaplGen( const ModelGenome::Gen& ); // Creates a new haploid genotype from a diploid genotype (see createOneHaplGen)
+   static int64_t sumHetLoc( const ModelGenome::Gen*, size_t ); // Sum of the heterozigotic loci of an array of genotypes. Parameters: pointer to the genotypes and number of genotypes
 
 private:
 
    char Sex; // gender: "m" for male, : "f" for male
-   uint64_t Gen; // genotype
+   ModelGenome::Gen Gen; // genotype
    double Phen; // phenotype value
 
    // Static data
    static int L; // number of bi-allelic loci per genotype
    static double Alpha; // effect size for each allele
+   static const double* Phenotypes; // phenotype per number of alleles "1" (PhenTable)
+   static std::vector<double> RuntimePhenotypes; // table used when the architecture is not the one fixed at compile time
 
    // Utility functions
-   int popcount64b(uint64_t) const; // Count 1-bits in a 64-bit integer
-   double sumAlpha(int nbites) const; // Used as part of the function that calculate Phen
    void displayBits(uint32_t) const; // Display bits of a 32-bit uinteger
    std::pair<uint32_t, uint32_t> pair32Int (uint64_t) const; // Create a pair of 32-bit uintegers from a 64-bit uinteger 
-   uint32_t freeRecombination(uint32_t,uint32_t) const; // Free-recombination algorithm
 
    };
 
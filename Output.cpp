@@ -14,6 +14,7 @@
 #include "Host.h"
 #include "Symbiont.h"
 #include "Simul.h"
+#include "Golden.h"
 
 using namespace std;
 
@@ -27,26 +28,40 @@ void Output::createOutputFiles(  ) {
       exit(1);
    }
 // 25/08/21: we don't need MAFS at this moments (heterozigosity metrics will be enough)
-//  output2.open("output/outputMAFH" + Simul::getScenID() + "_" + replid + ".csv");
-//  if( !output2 ) { // file couldn't be opened
-//      cerr << "Error: file output2 could not be opened" << endl;
-//      exit(1);
-//   }
-//  output3.open("output/outputMAFS" + Simul::getScenID() + "_" + replid + ".csv");
-//  if( !output3 ) { // file couldn't be opened
-//      cerr << "Error: file output3 could not be opened" << endl;
-//      exit(1);
-//   }
+// MAFS are only written if MAFOutput is true (allele counts are now cheap, see AlleleCounter)
+   if ( MAFOutput ) {
+     output2.open("output_full/outputMAFH" + Simul::getScenID() + "_" + replid + ".csv");
+     if( !output2 ) { // file couldn't be opened
+         cerr << "Error: file output2 could not be opened" << endl;
+         exit(1);
+      }
+     output3.open("output_full/outputMAFS" + Simul::getScenID() + "_" + replid + ".csv");
+     if( !output3 ) { // file couldn't be opened
+         cerr << "Error: file output3 could not be opened" << endl;
+         exit(1);
+      }
+   }
 }
 
 void Output::printHeadersToFiles(  ) {
    printHeader1( output1 );
-//   printHeader2( output2 );
-//   printHeader2( output3 );
+   if ( MAFOutput ) {
+      printHeader2( output2 );
+      printHeader2( output3 );
+   }
 }
 
 void Output::printDataToFiles( Population<Host>& hpp, const Metapopulation<Population<Symbiont>>& smpp ) {
-   printOutput1( output1, hpp, smpp );
+   if ( Golden::getMode() == Golden::ModeOff ) {
+      printOutput1( output1, hpp, smpp );
+   }
+   else { // the row is hashed by the golden-output regression harness
+      ostringstream row;
+      printOutput1( row, hpp, smpp );
+      output1 << row.str();
+      Golden::checkRow( row.str(), hpp, smpp );
+   }
+   if ( MAFOutput ) { printAlFreqToFiles( hpp, smpp ); }
 }
 
 void Output::printAlFreqToFiles( Population<Host>& hpp, const Metapopulation<Population<Symbiont>>& smpp ) {
@@ -87,7 +102,7 @@ void Output::printHeader2( ofstream& outf ) {
    outf << "Al" << Param::getL() << "\n"; // last entry
 }
 
-void Output::printOutput1( ofstream& outf, Population<Host>& hpp, const Metapopulation<Population<Symbiont>>& smpp ) {
+void Output::printOutput1( ostream& outf, Population<Host>& hpp, const Metapopulation<Population<Symbiont>>& smpp ) {
    outf << Simul::getScenID() << ","
       << Simul::getReplID() << ","    
       << (CurrSimStep/12)+1 << ","
@@ -137,9 +152,13 @@ int Output::getOutFreq() {return OutFreq;}
 void Output::setCurrSimStep( int cursimstep ) { CurrSimStep = cursimstep ; }
 int Output::getCurrSimStep() {return CurrSimStep;}
 
+void Output::setMAFOutput( bool mafoutput ) { MAFOutput = mafoutput ; }
+bool Output::getMAFOutput() {return MAFOutput;}
+
 // ---Static data members---
 int Output::OutFreq = Param::getOutFreq();
 int Output::CurrSimStep = 0;
+bool Output::MAFOutput = Param::getMAFOutput();
 ofstream Output::output1;
 ofstream Output::output2;
 ofstream Output::output3;
@@ -53,7 +53,7 @@ public:
    static void printHeader1( std::ofstream& );
    static void printHeader2( std::ofstream& );
 
-   static void printOutput1( std::ofstream&, Population<Host>&, const Metapopulation<Population<Symbiont>>& );
+   static void printOutput1( std::ostream&, Population<Host>&, const Metapopulation<Population<Symbiont>>& );
    static void printOutput2( std::ofstream&, const Population<Host>& );
    static void printOutput3( std::ofstream&, const Metapopulation<Population<Symbiont>>& );
 
@@ -63,10 +63,14 @@ public:
    static void setCurrSimStep( int ); // Set OutFreq
    static int getCurrSimStep(); // Get OutFreq
 
+   static void setMAFOutput( bool ); // Set MAFOutput
+   static bool getMAFOutput(); // Get MAFOutput
+
 private:
 
    static int OutFreq; // Frequency of output generation (measured in symbiont cycles)
    static int CurrSimStep; // Current simulation step (measured in symbiont cycles)
+   static bool MAFOutput; // Whether the allele frequencies are written into output2 (hosts) and output3 (symbionts)
    static std::ofstream output1;
    static std::ofstream output2;
    static std::ofstream output3;
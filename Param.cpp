@@ -1,6 +1,7 @@
 // Implementation of Param class
 
 #include <string>
+#include <algorithm> // std::min_element
 #include <iomanip>
 #include <stdexcept>
 #include <iostream>
@@ -13,10 +14,49 @@
 #include "Host.h"
 #include "Simul.h"
 #include "Output.h"
+#include "Profiler.h"
+#include "Golden.h"
+#include "Rng.h"
+#include "LocusEffects.h"
+#include "LinkageMap.h"
+#include "Population.h"
 
 using json = nlohmann::json;
 using namespace std;
 
+// ---Utility functions---
+
+// Input parameters that may be absent from the JSON file (their default values are kept if absent)
+static void inputOptParamFromJson( const json& inputData ) {
+   // Genetic architecture (more than 32 loci need a multi-word genome, see Genome.h)
+   if ( inputData.contains( "L" ) ) { Param::setL( inputData[ "L" ].get<int>() ); }
+   if ( inputData.contains( "Alpha" ) ) { Param::setAlpha( inputData[ "Alpha" ].get<double>() ); }
+   if ( inputData.contains( "LocusEffects" ) ) { Param::setLocEffects( inputData[ "LocusEffects" ].get<vector<double>>() ); }
+   if ( inputData.contains( "GenotypeClasses" ) ) { Param::setGenotypeClasses( inputData[ "GenotypeClasses" ].get<bool>() ); }
+   if ( inputData.contains( "LinkageMap" ) ) { Param::setLinkDistances( inputData[ "LinkageMap" ].get<vector<double>>() ); }
+   // Population sizes and duration (used by the benchmark scenarios in input/inputBench*.JSON)
+   if ( inputData.contains( "Ksymbiont" ) ) { Param::setKsymbiont( inputData[ "Ksymbiont" ].get<int>() ); }
+   if ( inputData.contains( "Khost" ) ) { Param::setKhost( inputData[ "Khost" ].get<int>() ); }
+   if ( inputData.contains( "SAb" ) ) { Param::setSAb( inputData[ "SAb" ].get<double>() ); }
+   if ( inputData.contains( "HPopVecSize" ) ) { Param::setHPopVecSize( inputData[ "HPopVecSize" ].get<size_t>() ); }
+   if ( inputData.contains( "SPopVecSize" ) ) { Param::setSPopVecSize( inputData[ "SPopVecSize" ].get<size_t>() ); }
+   if ( inputData.contains( "NYears" ) ) { Param::setNYears( inputData[ "NYears" ].get<int>() ); }
+   if ( inputData.contains( "MAFOutput" ) ) { Param::setMAFOutput( inputData[ "MAFOutput" ].get<bool>() ); }
+   // Instrumentation
+   if ( inputData.contains( "Profile" ) ) { Param::setProfile( inputData[ "Profile" ].get<bool>() ); }
+   if ( inputData.contains( "AllocReport" ) ) { Param::setAllocReport( inputData[ "AllocReport" ].get<bool>() ); }
+   if ( inputData.contains( "PerfCounters" ) ) { Param::setPerfReport( inputData[ "PerfCounters" ].get<bool>() ); }
+   if ( inputData.contains( "Bench" ) ) { Param::setBenchMode( inputData[ "Bench" ].get<bool>() ); }
+   if ( inputData.contains( "Golden" ) ) { Param::setGoldenMode( inputData[ "Golden" ].get<string>() ); }
+   if ( inputData.contains( "GoldenState" ) ) { Param::setGoldenState( inputData[ "GoldenState" ].get<bool>() ); }
+   // Random number streams
+   if ( inputData.contains( "RngStreams" ) ) { Param::setRngStreams( inputData[ "RngStreams" ].get<bool>() ); }
+   if ( inputData.contains( "Seed" ) ) { Param::setSeed( inputData[ "Seed" ].get<uint64_t>() ); }
+   if ( inputData.contains( "FromSeed" ) ) { Param::setFromSeed( inputData[ "FromSeed" ].get<bool>() ); }
+   if ( inputData.contains( "RngStateFormat" ) ) { Param::setRngStateFormat( inputData[ "RngStateFormat" ].get<string>() ); }
+   if ( inputData.contains( "LegacyRng" ) ) { Param::setLegacyRng( inputData[ "LegacyRng" ].get<bool>() ); }
+}
+
 // ---Static member functions---
 
 void Param::inputParamFromJsonFile( ) {
@@ -63,6 +103,7 @@ void Param::inputParamFromJsonFile( ) {
 //   setOutFreq( inputData[ "OutFreq" ].get<int>() );
 //   setmutRateH( inputData[ "mutRateH" ].get<double>() );
 //   setmutRateS( inputData[ "mutRateS" ].get<double>() );
+   inputOptParamFromJson( inputData );
 }
 
 void Param::inputParamFromJsonFile( string& path ) {
@@ -103,11 +144,36 @@ void Param::inputParamFromJsonFile( string& path ) {
 //   setOutFreq( inputData[ "OutFreq" ].get<int>() ); // default
 //   setmutRateH( inputData[ "mutRateH" ].get<double>() ); // default
 //   setmutRateS( inputData[ "mutRateS" ].get<double>() ); // default
+   inputOptParamFromJson( inputData );
 }
 
 void Param::initParam() {
+   if ( ModelGenome::NWords == 1 && getL() != ModelGenome::MaxL ) { // the single-word genome codes all the bits of its word as loci
+      cerr << "Error: L = " << getL() << " loci, but the single-word genome of this build holds exactly " << ModelGenome::MaxL
+         << " loci (compile with -DGENOME_WORDS=NW for 1 to 32 NW loci)" << endl;
+      exit(1);
+   }
+   if ( getL() < 1 || getL() > ModelGenome::MaxL ) {
+      cerr << "Error: L = " << getL() << " loci, but the genome of this build holds 1 to " << ModelGenome::MaxL
+         << " loci (compile with -DGENOME_WORDS=NW for up to 32 NW loci)" << endl;
+      exit(1);
+   }
+   if ( !getLocEffects().empty() && static_cast<int>( getLocEffects().size() ) != getL() ) {
+      cerr << "Error: \"LocusEffects\" has " << getLocEffects().size() << " effect sizes, but L = " << getL() << " loci" << endl;
+      exit(1);
+   }
+   if ( !getLinkDistances().empty() && ( static_cast<int>( getLinkDistances().size() ) != getL() - 1
+      || *min_element( getLinkDistances().begin(), getLinkDistances().end() ) < 0 ) ) {
+      cerr << "Error: \"LinkageMap\" must have L - 1 = " << getL() - 1 << " non-negative map distances (Morgans), but has "
+         << getLinkDistances().size() << endl;
+      exit(1);
+   }
    Organism::setL( getL() );
    Organism::setAlpha( getAlpha() );
+   Organism::initPhenTable();
+   LocusEffects::setEffects( getLocEffects() );
+   LinkageMap::setDistances( getLinkDistances() );
+   Population<Symbiont>::setGenotypeClasses( getGenotypeClasses() );
    Host::setKsymbiont( getKsymbiont() );
    Host::setRmax( getRmaxH() );
    Host::setVs( getVsH() );
@@ -124,8 +190,20 @@ void Param::initParam() {
    Simul::setScenID( getScenID() );
    Simul::setReplID( getReplID() );
    Output::setOutFreq( getOutFreq() );
+   Output::setMAFOutput( getMAFOutput() );
    Host::setmutRate( getmutRateH() );
    Symbiont::setmutRate( getmutRateS() );
+   Profiler::setEnabled( getProfile() );
+   Profiler::setAllocEnabled( getAllocReport() );
+   Profiler::setPerfEnabled( getPerfReport() );
+   Simul::setBenchMode( getBenchMode() );
+   Golden::setMode( getGoldenMode() );
+   Golden::setStateHash( getGoldenState() );
+   Rng::setStreamMode( getRngStreams() );
+   Rng::setSeed( getSeed() );
+   Rng::setFromSeed( getFromSeed() );
+   Rng::setStateFormat( getRngStateFormat() );
+   Rng::setLegacy( getLegacyRng() );
 }
 
 void Param::setL( int l ) { L = l; }
@@ -134,6 +212,15 @@ int Param::getL() {return L;};
 void Param::setAlpha( double alpha ) { Alpha = alpha ; }
 double Param::getAlpha() {return Alpha;}
 
+void Param::setLocEffects( const vector<double>& loceffects ) { LocEffects = loceffects; }
+const vector<double>& Param::getLocEffects() {return LocEffects;}
+
+void Param::setGenotypeClasses( bool genotypeclasses ) { GenotypeClasses = genotypeclasses; }
+bool Param::getGenotypeClasses() {return GenotypeClasses;}
+
+void Param::setLinkDistances( const vector<double>& linkdistances ) { LinkDistances = linkdistances; }
+const vector<double>& Param::getLinkDistances() {return LinkDistances;}
+
 void Param::setKsymbiont( int ks ) { Ksymbiont = ks ; }
 int Param::getKsymbiont() {return Ksymbiont;}
 
@@ -230,9 +317,48 @@ double Param::getmutRateH() {return mutRateH;}
 void Param::setmutRateS( double mtrs ) { mutRateS = mtrs; }
 double Param::getmutRateS() {return mutRateS;}
 
+void Param::setMAFOutput( bool mafoutput ) { MAFOutput = mafoutput; }
+bool Param::getMAFOutput() {return MAFOutput;}
+
+void Param::setProfile( bool profile ) { Profile = profile; }
+bool Param::getProfile() {return Profile;}
+
+void Param::setAllocReport( bool allocreport ) { AllocReport = allocreport; }
+bool Param::getAllocReport() {return AllocReport;}
+
+void Param::setPerfReport( bool perfreport ) { PerfReport = perfreport; }
+bool Param::getPerfReport() {return PerfReport;}
+
+void Param::setBenchMode( bool benchmode ) { BenchMode = benchmode; }
+bool Param::getBenchMode() {return BenchMode;}
+
+void Param::setGoldenMode( string goldenmode ) { GoldenMode = goldenmode; }
+string Param::getGoldenMode() {return GoldenMode;}
+
+void Param::setGoldenState( bool goldenstate ) { GoldenState = goldenstate; }
+bool Param::getGoldenState() {return GoldenState;}
+
+void Param::setRngStreams( bool rngstreams ) { RngStreams = rngstreams; }
+bool Param::getRngStreams() {return RngStreams;}
+
+void Param::setSeed( uint64_t seed ) { Seed = seed; }
+uint64_t Param::getSeed() {return Seed;}
+
+void Param::setFromSeed( bool fromseed ) { FromSeed = fromseed; }
+bool Param::getFromSeed() {return FromSeed;}
+
+void Param::setRngStateFormat( string rngstateformat ) { RngStateFormat = rngstateformat; }
+string Param::getRngStateFormat() {return RngStateFormat;}
+
+void Param::setLegacyRng( bool legacyrng ) { LegacyRng = legacyrng; }
+bool Param::getLegacyRng() {return LegacyRng;}
+
    // Static data members
 int Param::L = 32;
 double Param::Alpha = 0.15625;
+vector<double> Param::LocEffects;
+bool Param::GenotypeClasses = true;
+vector<double> Param::LinkDistances;
 int Param::Ksymbiont = 200;
 double Param::RmaxH = 1;
 double Param::VsH = 20;
@@ -265,6 +391,18 @@ int Param::ReplID = 0;
 int Param::OutFreq = 120;
 double Param::mutRateH = 0;
 double Param::mutRateS = 0;
+bool Param::MAFOutput = false;
+bool Param::Profile = false;
+bool Param::AllocReport = false;
+bool Param::PerfReport = false;
+bool Param::BenchMode = false;
+string Param::GoldenMode = "off";
+bool Param::GoldenState = false;
+bool Param::RngStreams = false;
+uint64_t Param::Seed = 0;
+bool Param::FromSeed = false;
+string Param::RngStateFormat = "text";
+bool Param::LegacyRng = true;
 
 // constructor
 
@@ -3,6 +3,8 @@
 #ifndef PARAM_H
 #define PARAM_H
 
+#include <vector> // C++ standard vector class template
+
 class Param {
 public:
    Param();
@@ -20,6 +22,15 @@ public:
    static void setAlpha( double ); // Set Alpha
    static double getAlpha(); // Get Alpha
 
+   static void setLocEffects( const std::vector<double>& ); // Set LocEffects
+   static const std::vector<double>& getLocEffects(); // Get LocEffects
+
+   static void setGenotypeClasses( bool ); // Set GenotypeClasses
+   static bool getGenotypeClasses(); // Get GenotypeClasses
+
+   static void setLinkDistances( const std::vector<double>& ); // Set LinkDistances
+   static const std::vector<double>& getLinkDistances(); // Get LinkDistances
+
    static void setKsymbiont( int ); // Set Ksymbiont
    static int getKsymbiont(); // Get Ksymbiont
 
@@ -116,10 +127,49 @@ public:
    static double getmutRateS(); // Get mutRateS
    static void setmutRateS( double ); // Set mutRateS
 
+   static void setMAFOutput( bool ); // Set MAFOutput
+   static bool getMAFOutput(); // Get MAFOutput
+
+   static void setProfile( bool ); // Set Profile
+   static bool getProfile(); // Get Profile
+
+   static void setAllocReport( bool ); // Set AllocReport
+   static bool getAllocReport(); // Get AllocReport
+
+   static void setPerfReport( bool ); // Set PerfReport
+   static bool getPerfReport(); // Get PerfReport
+
+   static void setBenchMode( bool ); // Set BenchMode
+   static bool getBenchMode(); // Get BenchMode
+
+   static void setGoldenMode( std::string ); // Set GoldenMode
+   static std::string getGoldenMode(); // Get GoldenMode
+
+   static void setGoldenState( bool ); // Set GoldenState
+   static bool getGoldenState(); // Get GoldenState
+
+   static void setRngStreams( bool ); // Set RngStreams
+   static bool getRngStreams(); // Get RngStreams
+
+   static void setSeed( uint64_t ); // Set Seed
+   static uint64_t getSeed(); // Get Seed
+
+   static void setFromSeed( bool ); // Set FromSeed
+   static bool getFromSeed(); // Get FromSeed
+
+   static void setRngStateFormat( std::string ); // Set RngStateFormat
+   static std::string getRngStateFormat(); // Get RngStateFormat
+
+   static void setLegacyRng( bool ); // Set LegacyRng
+   static bool getLegacyRng(); // Get LegacyRng
+
 private:
 
    static int L; // Number of bi-allelic loci per genotype (the same for both host and symbiont)
    static double Alpha; // Effect size for each allele (the same for both host and symbiont)
+   static std::vector<double> LocEffects; // Effect size of the alleles of each locus, replacing Alpha if not empty (optional JSON key "LocusEffects")
+   static bool GenotypeClasses; // Whether symbiont reproduction uses genotype classes when the diversity is low (optional JSON key "GenotypeClasses")
+   static std::vector<double> LinkDistances; // Map distances (Morgans) between adjacent loci for linked recombination, instead of free recombination if not empty (optional JSON key "LinkageMap")
    static int Ksymbiont; // Carrying capacity of a symbiont population inhabiting a host
    static double RmaxH; // Host intrinsic population growth rate
    static double VsH; // Width of stabilizing selection in hosts
@@ -152,6 +202,18 @@ private:
    static int ReplID; // ID of the simulation
    static double mutRateH; // Per allele, per generation mutation rate in hosts
    static double mutRateS; // Per allele, per generation mutation rate in symbionts
+   static bool MAFOutput; // Whether the allele frequencies of hosts and symbionts are written each output year (optional JSON key "MAFOutput")
+   static bool Profile; // Whether the per-phase profiler of the main loop is enabled (optional JSON key "Profile")
+   static bool AllocReport; // Whether heap allocations are reported per phase and output year (optional JSON key "AllocReport")
+   static bool PerfReport; // Whether hardware performance counters are reported per phase (optional JSON key "PerfCounters")
+   static bool BenchMode; // Whether the run reports throughput and peak memory at the end (optional JSON key "Bench")
+   static std::string GoldenMode; // Mode of the golden-output regression harness: off, record, verify or auto (optional JSON key "Golden")
+   static bool GoldenState; // Whether the golden harness also hashes the full host/symbiont state (optional JSON key "GoldenState")
+   static bool RngStreams; // Whether random numbers come from counter-based substreams per step, host and phase (optional JSON key "RngStreams")
+   static uint64_t Seed; // Master seed of the counter-based substreams or of the replicate engines (optional JSON key "Seed")
+   static bool FromSeed; // Whether the engine of each replicate is derived from Seed and ReplID instead of a state file (optional JSON key "FromSeed")
+   static std::string RngStateFormat; // Format of the saved engine states: text or binary (optional JSON key "RngStateFormat")
+   static bool LegacyRng; // Whether the standard library distributions are used instead of the fast samplers of Rng (optional JSON key "LegacyRng")
    };
 
    #endif // PARAM_H
@@ -0,0 +1,112 @@
+// Implementation of PerfCounters class
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <cstring> // memset() function
+#include <string>
+#include <iostream>
+#include "PerfCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// ---Static member functions---
+
+bool PerfCounters::open() {
+   if ( isOpen() ) { return true; }
+#ifdef __linux__
+   const uint32_t types[NCounters] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE };
+   const uint64_t configs[NCounters] = {
+      PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES, // usually mapped to last-level cache misses
+      PERF_COUNT_HW_BRANCH_MISSES
+   };
+   int leader = -1;
+   for ( int counter = 0; counter < NCounters; ++counter ) {
+      struct perf_event_attr attr;
+      memset( &attr, 0, sizeof(attr) );
+      attr.size = sizeof(attr);
+      attr.type = types[counter];
+      attr.config = configs[counter];
+      attr.disabled = ( leader == -1 ) ? 1 : 0; // the group is enabled through its leader
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP;
+      int fd = static_cast<int>( syscall( __NR_perf_event_open, &attr, 0, -1, leader, 0 ) );
+      if ( fd == -1 ) { // counter not available: the group continues without it
+         if ( counter == CounterCycles ) { break; } // without the leader the group cannot be created
+         continue;
+      }
+      if ( leader == -1 ) { leader = fd; }
+      Fd[counter] = fd;
+      Slot[counter] = NOpen;
+      ++NOpen;
+   }
+   if ( leader == -1 ) {
+      cerr << "Warning: hardware performance counters are not available (perf_event_open failed)" << endl;
+      NOpen = 0;
+      return false;
+   }
+   ioctl( leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+   ioctl( leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+   return true;
+#else
+   cerr << "Warning: hardware performance counters are only available in Linux" << endl;
+   return false;
+#endif
+}
+
+void PerfCounters::close() {
+#ifdef __linux__
+   if ( isOpen() ) {
+      ioctl( Fd[CounterCycles], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP );
+   }
+   for ( int counter = NCounters - 1; counter >= 0; --counter ) { // group members before the leader
+      if ( Fd[counter] != -1 ) { ::close( Fd[counter] ); }
+      Fd[counter] = -1;
+      Slot[counter] = -1;
+   }
+#endif
+   NOpen = 0;
+}
+
+bool PerfCounters::isOpen() {return NOpen > 0;}
+
+void PerfCounters::read( uint64_t* values ) {
+   for ( int counter = 0; counter < NCounters; ++counter ) { values[counter] = 0; }
+#ifdef __linux__
+   if ( !isOpen() ) { return; }
+   uint64_t buffer[1 + NCounters]; // {nr, values[nr]}
+   if ( ::read( Fd[CounterCycles], buffer, sizeof(buffer) ) <= 0 ) { return; }
+   for ( int counter = 0; counter < NCounters; ++counter ) {
+      if ( Slot[counter] != -1 && static_cast<uint64_t>( Slot[counter] ) < buffer[0] ) {
+         values[counter] = buffer[ 1 + Slot[counter] ];
+      }
+   }
+#endif
+}
+
+string PerfCounters::getCounterName( Counter counter ) {
+   switch ( counter ) {
+      case CounterCycles: return "Cycles";
+      case CounterInstructions: return "Instructions";
+      case CounterLLCMisses: return "LLCMisses";
+      case CounterBranchMisses: return "BranchMisses";
+      default: return "unknown";
+   }
+}
+
+// ---Static data members---
+int PerfCounters::Fd[NCounters] = { -1, -1, -1, -1 };
+int PerfCounters::Slot[NCounters] = { -1, -1, -1, -1 };
+int PerfCounters::NOpen = 0;
+
+// ---Constructor---
+
+PerfCounters::PerfCounters() {}
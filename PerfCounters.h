@@ -0,0 +1,47 @@
+// PerfCounters class definition
+
+/* Hardware performance counters of the process (Linux perf_event_open).
+   The counters (cycles, instructions, last-level cache misses and branch misses) are opened as one
+   group, so that they are read together with a single system call. The Profiler class reads them at
+   the start and at the end of each phase of the main loop to attribute the counts to phases.
+   In other systems, or if the kernel does not allow access to the counters (see
+   /proc/sys/kernel/perf_event_paranoid), open() returns false and all counts are zero.
+*/
+
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <string>
+
+class PerfCounters {
+public:
+
+   enum Counter {
+      CounterCycles = 0, // CPU cycles
+      CounterInstructions, // retired instructions
+      CounterLLCMisses, // last-level cache misses
+      CounterBranchMisses, // mispredicted branches
+      NCounters // number of counters (not a counter)
+   };
+
+   PerfCounters(); // constructor
+
+   // Static member functions
+
+   static bool open(); // Open and start the counters (returns false if they are not available)
+   static void close(); // Stop and close the counters
+   static bool isOpen(); // Whether the counters are open
+
+   static void read( uint64_t* ); // Read the current values of the NCounters counters
+
+   static std::string getCounterName( Counter ); // Get the name of a counter
+
+private:
+
+   static int Fd[NCounters]; // File descriptor of each counter (-1 if not available)
+   static int Slot[NCounters]; // Position of each counter in the group read (-1 if not available)
+   static int NOpen; // Number of counters opened in the group
+   };
+
+   #endif // PERFCOUNTERS_H
@@ -0,0 +1,48 @@
+// PhenTable class definition
+// Member functions are defined within the class definition's body so that they can be evaluated at compile time
+
+/* Table of the phenotype of an individual as a function of its number n of alleles "1" (0 <= n <= NAl,
+   where NAl is the number of alleles the phenotype counts, ModelGenome::nAlleles):
+      Phen[n] = (Alpha + ... + Alpha, n times) - (Alpha + ... + Alpha, NAl - n times)
+   Each sum is accumulated by repeated addition, in the same order as the loop that used to compute the
+   phenotype of each individual (Organism::sumAlpha), so the table lookup gives bit-identical phenotypes.
+   fill is constexpr, so a table whose genetic architecture is fixed at compile time (Fixed, used by
+   Organism when compiled with -DFIXED_ALPHA) is computed by the compiler.
+*/
+
+#ifndef PHENTABLE_H
+#define PHENTABLE_H
+
+class PhenTable {
+public:
+
+   // Fill phen[0] to phen[nal] for an effect size alpha of each allele
+   static constexpr void fill( double* phen, int nal, double alpha ) {
+      double sum = 0;
+      phen[0] = sum;
+      for ( int n = 1; n <= nal; ++n ) { // phen[n]: n times alpha
+         sum += alpha;
+         phen[n] = sum;
+      }
+      for ( int n = 0; n <= nal - n; ++n ) { // phen[n] - phen[nal-n] in place
+         double ones = phen[n];
+         double zeros = phen[ nal - n ];
+         phen[n] = ones - zeros;
+         phen[ nal - n ] = zeros - ones;
+      }
+   }
+
+   // Table computed at compile time for NAl alleles
+   template<int NAl>
+   class Fixed {
+   public:
+      constexpr explicit Fixed( double alpha ): Phen() { fill( Phen, NAl, alpha ); }
+      constexpr double operator[]( int n ) const { return Phen[n]; }
+      const double* data() const { return Phen; }
+      static const int NAlleles = NAl; // Number of alleles counted by the phenotype
+   private:
+      double Phen[NAl + 1];
+      };
+   };
+
+   #endif // PHENTABLE_H
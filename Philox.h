@@ -0,0 +1,86 @@
+// Philox4x32 class definition
+// Member functions are defined within the class definition's body so that they can be inlined
+
+/* Counter-based random number engine Philox4x32-10 (Salmon et al. 2011, "Parallel random numbers:
+   as easy as 1, 2, 3"). Each 128-bit counter is mapped to four 32-bit random words by ten rounds
+   of a keyed bijection, so any position of any stream can be computed directly, without storing
+   or advancing an engine state:
+      key     = 64 bits (e.g. derived from the master seed and the replicate)
+      counter = block index within the stream (32 bits) + stream identifier (96 bits)
+   It satisfies the UniformRandomBitGenerator requirements, so it can be used with the standard
+   distributions.
+*/
+
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <cstdint> // uint32_t and uint64_t types
+
+class Philox4x32 {
+public:
+   typedef uint32_t result_type;
+
+   static constexpr result_type min() { return 0; }
+   static constexpr result_type max() { return 0xFFFFFFFF; }
+
+   Philox4x32() : Key{0, 0}, Ctr{0, 0, 0, 0}, Buffer{0, 0, 0, 0}, Pos(4) {} // constructor
+   Philox4x32( uint64_t key ) : Philox4x32() { setKey( key ); } // constructor
+
+   // Set the key (the same key and counter always give the same random words)
+   void setKey( uint64_t key ) {
+      Key[0] = static_cast<uint32_t>( key );
+      Key[1] = static_cast<uint32_t>( key >> 32 );
+      Pos = 4;
+   }
+
+   // Select a stream (96-bit identifier) and restart it from its first block
+   void setStream( uint32_t id0, uint32_t id1, uint32_t id2 ) {
+      Ctr[0] = 0;
+      Ctr[1] = id0;
+      Ctr[2] = id1;
+      Ctr[3] = id2;
+      Pos = 4;
+   }
+
+   // Get the next 32-bit random word of the current stream
+   result_type operator()() {
+      if ( Pos == 4 ) {
+         block( Ctr, Key, Buffer );
+         ++Ctr[0]; // next block of the same stream
+         Pos = 0;
+      }
+      return Buffer[Pos++];
+   }
+
+   // Compute the four random words of one counter (10 rounds)
+   static void block( const uint32_t* ctr, const uint32_t* key, uint32_t* out ) {
+      uint32_t c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+      uint32_t k0 = key[0], k1 = key[1];
+      for ( int round = 0; round < 10; ++round ) {
+         if ( round > 0 ) { // bump the key between rounds
+            k0 += 0x9E3779B9;
+            k1 += 0xBB67AE85;
+         }
+         uint64_t p0 = static_cast<uint64_t>( 0xD2511F53 ) * c0;
+         uint64_t p1 = static_cast<uint64_t>( 0xCD9E8D57 ) * c2;
+         uint32_t hi0 = static_cast<uint32_t>( p0 >> 32 ), lo0 = static_cast<uint32_t>( p0 );
+         uint32_t hi1 = static_cast<uint32_t>( p1 >> 32 ), lo1 = static_cast<uint32_t>( p1 );
+         c0 = hi1 ^ c1 ^ k0;
+         c1 = lo1;
+         c2 = hi0 ^ c3 ^ k1;
+         c3 = lo0;
+      }
+      out[0] = c0;
+      out[1] = c1;
+      out[2] = c2;
+      out[3] = c3;
+   }
+
+private:
+   uint32_t Key[2]; // 64-bit key
+   uint32_t Ctr[4]; // Ctr[0] = block index, Ctr[1..3] = stream identifier
+   uint32_t Buffer[4]; // random words of the last computed block
+   int Pos; // next word of Buffer to return (4 = buffer exhausted)
+   };
+
+   #endif // PHILOX_H
@@ -11,14 +11,30 @@
 #include<stack> // C++ standard stack class template
 #include <string> // C++ standard string class
 #include "Population.h" // Organism class definition
+#include "LocusEffects.h"
 
 using namespace std;
 
 // Population<Symbiont> member function definitions
 // Full specialization is not a template: no "template <>" prefix in member function definitions
 
+   // Static member functions
+
+void Population<Symbiont>::setGenotypeClasses( bool genotypeclasses ) { GenotypeClasses = genotypeclasses; }
+bool Population<Symbiont>::getGenotypeClasses() {return GenotypeClasses;}
+
+   // Static data members
+
+bool Population<Symbiont>::GenotypeClasses = Param::getGenotypeClasses();
+vector<Population<Symbiont>::GenClass> Population<Symbiont>::FemaleClasses;
+vector<Population<Symbiont>::GenClass> Population<Symbiont>::MaleClasses;
+vector<double> Population<Symbiont>::ClassMeans;
+vector<int> Population<Symbiont>::ClassNGametes;
+vector<int64_t> Population<Symbiont>::ClassCumGametes;
+vector<int> Population<Symbiont>::GameteSlots;
+
    // Constructor
-Population<Symbiont>::Population(const size_t PopVecSize, int n, uint64_t hid, uint64_t id): Pop(std::vector<Symbiont>(PopVecSize)), N(n), PatchID(hid), ID(id) {} // Here, the patch is a host
+Population<Symbiont>::Population(const size_t PopVecSize, int n, uint64_t hid, uint64_t id): Gens(PopVecSize), Phens(PopVecSize), FemaleBits( ( PopVecSize + 63 ) / 64 ), N(n), PatchID(hid), ID(id), ClassCheck(0) {} // Here, the patch is a host
 
    // Non-static member functions
 
@@ -32,21 +48,17 @@ void Population<Symbiont>::newIndFromSource( Population<Host>& hpop, const Sourc
    double alpha2 = Symbiont::getAlpha() + Symbiont::getAlpha();
    double kd = l + newPhen/alpha2;
    int k = static_cast<int>(round( kd ));
-   // Get a random 64-bit integer with k 1-bits
-   uint64_t newGen = rng.random_k_bits(k);
+   // Get a random genotype with k alleles "1"
+   ModelGenome::Gen newGen = ModelGenome::randomGen(k, Symbiont::getL(), rng);
    // Initialize sex, genotype and phenotype of the new individual:
-   Pop[indexInd].setSex( ( Rng::unif_01() > 0.5 )? 'f' : 'm' );
-   Pop[indexInd].setGen(newGen);
-   Pop[indexInd].Phen_init();
+   setNewInd( indexInd, newGen, true );
 }
 
 void Population<Symbiont>::newLocAdIndFromSource( Population<Host>& hpop, const SourcePatch& continent, Rng& rng ) { // local resident (locally adapted)
    // Create new individual and get its index
    int indexInd = createInd(hpop);
    // Get the phenotype value of the host (i.e. the local optimum)
-   Host* ptrHost = hpop.getInd ( getPatchID() ); // hpop is the name of the host population
-   double LocOptPhen = ptrHost->getPhen();
-   ptrHost = nullptr;
+   double LocOptPhen = hpop.getPhen( getPatchID() ); // hpop is the name of the host population
    // Sample a locally adapted phenotype value from the continent (based on the local optimum)
    double newPhen = rng.normal( LocOptPhen, continent.getLocStdPhenS() );
    // Calculate number of 1-bits (k) that would produce the newPhen
@@ -54,27 +66,33 @@ void Population<Symbiont>::newLocAdIndFromSource( Population<Host>& hpop, const
    double alpha2 = Symbiont::getAlpha() + Symbiont::getAlpha();
    double kd = l + newPhen/alpha2;
    int k = static_cast<int>(round( kd ));
-   // Get a random 64-bit integer with k 1-bits
-   uint64_t newGen = rng.random_k_bits(k);
+   // Get a random genotype with k alleles "1"
+   ModelGenome::Gen newGen = ModelGenome::randomGen(k, Symbiont::getL(), rng);
    // Initialize sex, genotype and phenotype of the new individual:
-   Pop[indexInd].setSex( ( Rng::unif_01() > 0.5 )? 'f' : 'm' );
-   Pop[indexInd].setGen(newGen);
-   Pop[indexInd].Phen_init();
+   setNewInd( indexInd, newGen, true );
 }
 
 void Population<Symbiont>::newBorn( Population<Host>& hpop, Rng& rng, Gamete& gamete1, Gamete& gamete2) {
    // Create new individual and get its index
    int indexInd = createInd(hpop);
    // Create a new genotype from the parental gametes
-   uint64_t newGen = GenfromGametes( gamete1, gamete2 );
+   ModelGenome::Gen newGen = GenfromGametes( gamete1, gamete2 );
    // Apply mutation
    if ( Symbiont::getmutRate() > 0 ) {
       newGen = genMutation( newGen, rng );
    }
-   // Initialize sex, genotype and phenotype of the new individual:
-   Pop[indexInd].setSex( ( Rng::unif_01() > 0.5 )? 'f' : 'm' );
-   Pop[indexInd].setGen(newGen);
-   Pop[indexInd].Phen_init();
+   // Initialize sex, genotype and phenotype of the new individual (the phenotype is evaluated in batch by popReproduction with per-locus effects):
+   setNewInd( indexInd, newGen, !LocusEffects::getActive() );
+}
+
+void Population<Symbiont>::newBorn( Population<Host>& hpop, Rng& rng, Gamete& gamete1, Gamete& gamete2, MutationScatter& mutations ) {
+   // Create new individual and get its index
+   int indexInd = createInd(hpop);
+   // Create a new genotype from the parental gametes and apply its mutations
+   ModelGenome::Gen newGen = GenfromGametes( gamete1, gamete2 );
+   ModelGenome::mutate( newGen, mutations, Symbiont::getL(), rng );
+   // Initialize sex, genotype and phenotype of the new individual (the phenotype is evaluated in batch by popReproduction with per-locus effects):
+   setNewInd( indexInd, newGen, !LocusEffects::getActive() );
 }
 
 int Population<Symbiont>::newImmigrant( Population<Host>& hpop) {
@@ -84,25 +102,47 @@ int Population<Symbiont>::newImmigrant( Population<Host>& hpop) {
 
 void Population<Symbiont>::removeInd( Population<Host>& hpop , int index) {
    if ( index < N-1 ) {
-   std::swap(Pop[index],Pop[N-1]);
+   swapInd( index, *this, N-1 );
    --N;
    // Update Nsymbiont of the host harbouring this symbiont population
-   Host* ptrHost = hpop.getInd ( getPatchID() ); // hpop is the name of the host population
-   --(*ptrHost);
-   ptrHost = nullptr;
+   hpop.addNsymbiont( getPatchID(), -1 ); // hpop is the name of the host population
    }
    else {
    --N;
    // Update Nsymbiont of the host harbouring this symbiont population
-   Host* ptrHost = hpop.getInd ( getPatchID() ); // hpop is the name of the host population
-   --(*ptrHost);
+   hpop.addNsymbiont( getPatchID(), -1 ); // hpop is the name of the host population
    }
 }
 
-void Population<Symbiont>::setPop(const std::vector<Symbiont>& pop) { Pop = pop; }
-const std::vector<Symbiont>& Population<Symbiont>::getPop() const {return Pop;}
+void Population<Symbiont>::setPop(const std::vector<Symbiont>& pop) {
+   Gens.resize( pop.size() );
+   Phens.resize( pop.size() );
+   FemaleBits.assign( ( pop.size() + 63 ) / 64, 0 );
+   for ( size_t i = 0; i < pop.size(); ++i ) { setInd( static_cast<int>( i ), pop[i] ); }
+}
+vector<Symbiont> Population<Symbiont>::getPop() const {
+   vector<Symbiont> pop;
+   pop.reserve( Gens.size() );
+   for ( size_t i = 0; i < Gens.size(); ++i ) { pop.push_back( getInd( static_cast<int>( i ) ) ); }
+   return pop;
+}
+size_t Population<Symbiont>::getCapacity() const {return Gens.size();}
 
-Symbiont* Population<Symbiont>::getPtrToInd( int indexInd ) {return &Pop[indexInd];}
+Symbiont Population<Symbiont>::getInd( int indexInd ) const {
+   return Symbiont( isFemale( indexInd ) ? 'f' : 'm', Gens[indexInd], Phens[indexInd] );
+}
+void Population<Symbiont>::setInd( int indexInd, const Symbiont& ind ) {
+   Gens[indexInd] = ind.getGen();
+   Phens[indexInd] = ind.getPhen();
+   setFemale( indexInd, ind.getSex() == 'f' );
+}
+void Population<Symbiont>::swapInd( int indexInd, Population<Symbiont>& other, int otherIndex ) {
+   std::swap( Gens[indexInd], other.Gens[otherIndex] );
+   std::swap( Phens[indexInd], other.Phens[otherIndex] );
+   bool female = isFemale( indexInd );
+   setFemale( indexInd, other.isFemale( otherIndex ) );
+   other.setFemale( otherIndex, female );
+}
 
 void Population<Symbiont>::setN(int n) {N = n;}
 int Population<Symbiont>::getN() const {return N;}
@@ -112,16 +152,14 @@ uint64_t Population<Symbiont>::getPatchID() const {return PatchID;}
 
 void Population<Symbiont>::setID(uint64_t id) {ID = id;}
 uint64_t Population<Symbiont>::getID() const {return ID;}
+void Population<Symbiont>::resetClassCheck() {ClassCheck = 0;}
 
 void Population<Symbiont>::immigrFromSource( const SourcePatch& continent, Rng& rng, Population<Host>& hpop) {
    if ( (continent.getSPrev() > Rng::unif_01() ) || (continent.getSPrev() == 1) ) {  // Determine whether the population is not empty
       // Sample the number of individuals in the population (for a non-empty population)
-      int n_ind = rng.negative_binomial( continent.getSAb(), continent.getSTheta() );
-      while ( n_ind == 0 ) { // To sample an n_ind > 0
-         n_ind = rng.negative_binomial( continent.getSAb(), continent.getSTheta() );
-      }
-      if ( n_ind > static_cast<int>( getPop().size() ) ) { // To prevent from Pop vector overflow
-         n_ind = static_cast<int>( getPop().size() );
+      int n_ind = rng.negative_binomial_zt( continent.getSAb(), continent.getSTheta() ); // To sample an n_ind > 0
+      if ( n_ind > static_cast<int>( getCapacity() ) ) { // To prevent from Pop vector overflow
+         n_ind = static_cast<int>( getCapacity() );
       }
       // Estimate the number of locally adapted symbionts
       int n_locad = rng.binomial( n_ind, continent.getPSLocAd() );
@@ -142,13 +180,26 @@ void Population<Symbiont>::immigrFromSource( const SourcePatch& continent, Rng&
 }
 
 void Population<Symbiont>::popReproduction ( Population<Host>& hpop, Rng& rng) {
+   if ( !Rng::getLegacy() ) {
+      // Few distinct genotypes: gametes drawn per genotype class (the check itself draws no random numbers,
+      // and after a failed check the next ClassCheckPeriod reproductive events skip it)
+      bool classes = false;
+      if ( GenotypeClasses ) {
+         if ( ClassCheck > 0 ) { --ClassCheck; }
+         else if ( buildClasses( true ) ) { classes = true; }
+         else { ClassCheck = ClassCheckPeriod; }
+      }
+      // Otherwise each individual is a class of its own: the gamete pools are not materialised either
+      if ( !classes ) { buildClasses( false ); }
+      classReproduction( hpop, rng );
+      return;
+   }
+   // Legacy samplers: the gamete pools are materialised, to keep the original order of the random draws
    // Produce the gamete pool:
    gpool gamPool = produceGametePool( hpop, rng );
    // Reset population
    N=0;
-   Host* ptrHost = hpop.getInd( getPatchID() );
-   ptrHost->setNsymbiont(0);
-   ptrHost = nullptr;
+   hpop.setNsymbiont( getPatchID(), 0 );
    // Produce newborn individuals from the gamete pool:
    vector<int> randgF = rng.randIndexVect( gamPool.first.size() );
    vector<int> randgM = rng.randIndexVect( gamPool.second.size() );
@@ -164,12 +215,13 @@ void Population<Symbiont>::popReproduction ( Population<Host>& hpop, Rng& rng) {
       for ( int i = 0; i < NnewBorn; ++i ) {
          newBorn( hpop, rng, gamPool.first[randgF[i]], gamPool.second[randgM[i]] );
       }
+      if ( LocusEffects::getActive() ) { batchPhenotypes(); }
    }
 }
 
 void Population<Symbiont>::printIndividuals () const {
    for (int counter = 0; counter < N; ++counter) {
-   Pop[counter].printIndividual();
+   getInd(counter).printIndividual();
    }
 }
 
@@ -181,7 +233,7 @@ double Population<Symbiont>::getAvSPhen() const {
    if (N>0) {
       double SumPhen = 0;
       for (int counter = 0; counter < N; ++counter) {
-         SumPhen += Pop[counter].getPhen();
+         SumPhen += Phens[counter];
       }
       return ( SumPhen / static_cast<double>(N) );
    }
@@ -193,7 +245,7 @@ double Population<Symbiont>::getSSPhen() const {
       double mean = getAvSPhen();
       double var = 0;
       for (int counter = 0; counter < N; ++counter) {
-         var += pow( ( Pop[counter].getPhen() - mean ), 2) ;
+         var += pow( ( Phens[counter] - mean ), 2) ;
       }
       return ( var );
    }
@@ -204,7 +256,7 @@ double Population<Symbiont>::getSumPhen() const {
    if (N>0) {
       double SumPhen = 0;
       for (int counter = 0; counter < N; ++counter) {
-         SumPhen += Pop[counter].getPhen();
+         SumPhen += Phens[counter];
       }
       return ( SumPhen );
    }
@@ -216,9 +268,7 @@ double Population<Symbiont>::getDevSPhen( Population<Host>& hpop ) const {
       // Obtain the average symbiont phenotype within the host
       double avphensymb = getAvSPhen();
       // Obtain the host phenotype
-      Host* ptrHost = hpop.getInd( getPatchID() );
-      double hostphen = ptrHost->getPhen();
-      ptrHost = nullptr;
+      double hostphen = hpop.getPhen( getPatchID() );
       // Notice that here we do not have to divide by hostphen because our optimal phenotype for the island is equal to zero
       return ( avphensymb - hostphen );
    }
@@ -227,25 +277,120 @@ double Population<Symbiont>::getDevSPhen( Population<Host>& hpop ) const {
 
 void Population<Symbiont>::getAlFreq( vector<int>& alfreq ) const {
    if ( N > 0 ) {
-      for ( int counter = 0; counter < N; ++counter ) {
-         pair<uint32_t, uint32_t> pairgen = pair32Int( Pop[counter].getGen() );
-        // Lower "haploid" part of the int representing the genotipe
-         sumAlToAlFreq( pairgen.first, alfreq );
-         sumAlToAlFreq( pairgen.second, alfreq );
-      }
+      ModelGenome::Counter alleles;
+      addAlleles( alleles );
+      alleles.addTo( alfreq );
    }
 }
 
-int Population<Symbiont>::getSumHetPop () const {
-   int sumhetpop = 0;
-   for ( int i=0; i < N ; ++i ) {
-      sumhetpop += Pop[i].sumHetLocInd();
+void Population<Symbiont>::addAlleles( ModelGenome::Counter& alleles ) const {
+   for ( int counter = 0; counter < N; ++counter ) {
+      alleles.add( Gens[counter] ); // both "haploid" parts of the int representing the genotype
    }
-   return(sumhetpop);
+}
+
+int Population<Symbiont>::getSumHetPop () const {
+   // The genotypes are contiguous: heterozygosity kernel over the whole array (one popcount per two individuals)
+   return( static_cast<int>( Organism::sumHetLoc( Gens.data(), static_cast<size_t>( N ) ) ) );
 }
 
    // Utility functions
 
+void Population<Symbiont>::batchPhenotypes() {
+   // The genotypes and phenotypes are contiguous: per-locus effects kernel over the whole arrays
+   LocusEffects::phenotypes( Gens.data(), static_cast<size_t>( N ), Phens.data() );
+}
+
+void Population<Symbiont>::setNewInd( int indexInd, const ModelGenome::Gen& gen, bool phenotype ) {
+   setFemale( indexInd, Rng::unif_01() > 0.5 );
+   Gens[indexInd] = gen;
+   if ( phenotype ) { Phens[indexInd] = Organism::phenotype( gen ); }
+}
+
+bool Population<Symbiont>::buildClasses( bool merge ) {
+   // Sort the genotypes of each sex and merge the identical ones
+   FemaleClasses.clear();
+   MaleClasses.clear();
+   for ( int i = 0; i < N; ++i ) {
+      GenClass genclass = { Gens[i], i, 1, false };
+      ( isFemale( i ) ? FemaleClasses : MaleClasses ).push_back( genclass );
+   }
+   if ( !merge ) { // one class per individual
+      for ( vector<GenClass>* classes : { &FemaleClasses, &MaleClasses } ) {
+         for ( GenClass& genclass : *classes ) { genclass.Homozygous = ( ModelGenome::countHet( genclass.Gen ) == 0 ); }
+      }
+      return( N > 0 );
+   }
+   for ( vector<GenClass>* classes : { &FemaleClasses, &MaleClasses } ) {
+      sort( classes->begin(), classes->end(), []( const GenClass& a, const GenClass& b ) { return ModelGenome::lessGen( a.Gen, b.Gen ); } );
+      size_t n = 0;
+      for ( size_t i = 0; i < classes->size(); ++i ) {
+         if ( n > 0 && ModelGenome::equalGen( (*classes)[ n - 1 ].Gen, (*classes)[i].Gen ) ) { ++(*classes)[ n - 1 ].Count; }
+         else { (*classes)[ n++ ] = (*classes)[i]; }
+      }
+      classes->resize( n );
+      for ( GenClass& genclass : *classes ) { genclass.Homozygous = ( ModelGenome::countHet( genclass.Gen ) == 0 ); }
+   }
+   return( N > 0 && static_cast<int>( FemaleClasses.size() + MaleClasses.size() ) * ClassRatio <= N );
+}
+
+void Population<Symbiont>::classReproduction( Population<Host>& hpop, Rng& rng ) {
+   // Number of gametes of each class: the sum of Count Poisson numbers, i.e. Poisson with Count times the mean of one individual
+   const int nfclasses = static_cast<int>( FemaleClasses.size() );
+   const double hostN = static_cast<double>( hpop.getNsymbiont( PatchID ) );
+   const double hostPhen = hpop.getPhen( PatchID );
+   ClassMeans.clear();
+   for ( const vector<GenClass>* classes : { &FemaleClasses, &MaleClasses } ) {
+      for ( const GenClass& genclass : *classes ) { ClassMeans.push_back( genclass.Count * Symbiont::meanNGametes( Phens[ genclass.Index ], hostN, hostPhen ) ); }
+   }
+   rng.poisson( ClassMeans, ClassNGametes );
+   int64_t nfgametes = 0;
+   int64_t nmgametes = 0;
+   for ( int c = 0; c < static_cast<int>( ClassNGametes.size() ); ++c ) { ( c < nfclasses ? nfgametes : nmgametes ) += ClassNGametes[c]; }
+   // Reset population
+   N=0;
+   hpop.setNsymbiont( getPatchID(), 0 );
+   int NnewBorn = static_cast<int>( min( nfgametes, nmgametes ) );
+   if ( NnewBorn == 0 ) { return; }
+   // Every gamete of the smaller pool is paired with a distinct random gamete of the larger pool, so only the
+   // gametes of the newborns are produced. The gametes of the larger pool are numbered class by class (slots),
+   // and NnewBorn of them are drawn without replacement, in random order, by a partial Fisher-Yates shuffle
+   const bool femalesPaired = ( nfgametes <= nmgametes ); // whether the female pool is the smaller one
+   const vector<GenClass>& small = femalesPaired ? FemaleClasses : MaleClasses;
+   const vector<GenClass>& large = femalesPaired ? MaleClasses : FemaleClasses;
+   const int* smallNGametes = ClassNGametes.data() + ( femalesPaired ? 0 : nfclasses );
+   const int* largeNGametes = ClassNGametes.data() + ( femalesPaired ? nfclasses : 0 );
+   const int nlarge = static_cast<int>( femalesPaired ? nmgametes : nfgametes );
+   ClassCumGametes.clear();
+   int64_t cum = 0;
+   for ( size_t c = 0; c < large.size(); ++c ) {
+      cum += largeNGametes[c];
+      ClassCumGametes.push_back( cum );
+   }
+   GameteSlots.resize( nlarge );
+   iota( GameteSlots.begin(), GameteSlots.end(), 0 );
+   for ( int j = 0; j < NnewBorn; ++j ) { swap( GameteSlots[j], GameteSlots[ j + static_cast<int>( rng.uniform_below( static_cast<uint32_t>( nlarge - j ) ) ) ] ); }
+   // Produce newborn individuals from the pairs of gametes
+   MutationScatter mutations( Symbiont::getmutRate() );
+   int j = 0;
+   for ( size_t c = 0; c < small.size(); ++c ) {
+      for ( int g = 0; g < smallNGametes[c]; ++g, ++j ) {
+         int partner = static_cast<int>( upper_bound( ClassCumGametes.begin(), ClassCumGametes.end(), static_cast<int64_t>( GameteSlots[j] ) ) - ClassCumGametes.begin() );
+         Gamete smallGamete = classGamete( small[c] );
+         Gamete largeGamete = classGamete( large[ partner ] );
+         if ( femalesPaired ) { newBorn( hpop, rng, smallGamete, largeGamete, mutations ); }
+         else { newBorn( hpop, rng, largeGamete, smallGamete, mutations ); }
+      }
+   }
+   if ( LocusEffects::getActive() ) { batchPhenotypes(); }
+}
+
+Gamete Population<Symbiont>::classGamete( const GenClass& genclass ) const {
+   // Recombination only changes the gametes of the heterozygous genotypes
+   if ( genclass.Homozygous ) { return( Gamete( ModelGenome::haplotype( genclass.Gen, 0 ) ) ); }
+   return( Gamete( Organism::createHaplGen( genclass.Gen ) ) ); // (not from Gens[Index], which may already hold a newborn)
+}
+
 std::string Population<Symbiont>::PopulationtoString() const {
    std::ostringstream output;
    output << "N = " << getN()
@@ -259,14 +404,12 @@ std::string Population<Symbiont>::PopulationtoString() const {
 }
 
 int Population<Symbiont>::createInd( Population<Host>& hpop) {
-   if (static_cast<uint32_t>(N) < Pop.size()) {
+   if (static_cast<uint32_t>(N) < Gens.size()) {
    int n = N;
    // Update N
    ++N;
    // Update Nsymbiont of the host harbouring this symbiont population
-   Host* ptrHost = hpop.getInd ( getPatchID() ); // hpop is the name of the host population
-   ++(*ptrHost);
-   ptrHost = nullptr;
+   hpop.addNsymbiont( getPatchID(), 1 ); // hpop is the name of the host population
    // Return the index of the new symbiont
    return(n);
    }
@@ -276,10 +419,9 @@ int Population<Symbiont>::createInd( Population<Host>& hpop) {
    }
 }
 
-uint64_t Population<Symbiont>::GenfromGametes(const Gamete& gamete1, const Gamete& gamete2) const {
-   // (uint64_t) mostSignificantWord << 32 | leastSignificantWord
-   uint64_t newGen = (uint64_t) gamete1.getHaplGen() << 32 | gamete2.getHaplGen();
-   return(newGen);
+ModelGenome::Gen Population<Symbiont>::GenfromGametes(const Gamete& gamete1, const Gamete& gamete2) const {
+   // the haplotype of gamete1 is the upper one (see Genome)
+   return( ModelGenome::fromGametes( gamete1.getHaplGen(), gamete2.getHaplGen() ) );
 }
 
 Population<Symbiont>::gpool Population<Symbiont>::produceGametePool( const Population<Host>& hpop, Rng& rng) const {
@@ -287,45 +429,32 @@ Population<Symbiont>::gpool Population<Symbiont>::produceGametePool( const Popul
    vector<Gamete> MaleGam;
    FemaleGam.reserve(Host::getKsymbiont());
    MaleGam.reserve(Host::getKsymbiont());
+   // Expected numbers of gametes from the phenotypes (the host is the same for all the individuals)
+   const double hostN = static_cast<double>( hpop.getNsymbiont( PatchID ) );
+   const double hostPhen = hpop.getPhen( PatchID );
+   // Legacy order of the random draws: the number of gametes of an individual, then its gametes
    for ( int i = 0; i < N; ++i ) {
-      vector<Gamete> GamInd = Pop[i].produceGametes( PatchID, hpop, rng );
-      if ( Pop[i].getSex() == 'f' ) {
-         FemaleGam.insert( FemaleGam.end(), GamInd.begin(),GamInd.end());
-//cout << "Added to female pool: " << GamInd.size() << " gametes\n";
-//for (const auto& i:GamInd) {i.printHaplGen();}
-      }
-      else {
-         MaleGam.insert( MaleGam.end(), GamInd.begin(),GamInd.end());
-//cout << "Added to male pool: " << GamInd.size() << " gametes\n";
-//for (const auto& i:GamInd) {i.printHaplGen();}
-      }
+      int ngametes = rng.poisson( Symbiont::meanNGametes( Phens[i], hostN, hostPhen ) );
+      vector<Gamete>& GamPool = isFemale( i ) ? FemaleGam : MaleGam;
+      for ( int g = 0; g < ngametes; ++g ) { GamPool.push_back( Gamete( Organism::createHaplGen( Gens[i] ) ) ); }
    }
    return (pair<vector<Gamete>,vector<Gamete>>( FemaleGam, MaleGam ));
 }
 
-void Population<Symbiont>::sumAlToAlFreq ( uint32_t haplgen , vector<int>& alfrq ) const {
-   const uint32_t SHIFT{8 * sizeof(uint32_t) - 1};
-   const uint32_t MASK{static_cast<const uint32_t>(1 << SHIFT)};
-   for (uint32_t i{1}; i <= SHIFT + 1; ++i) {
-      if (haplgen & MASK) {++alfrq[i-1];}
-      haplgen <<= 1; // shift haplgen left by 1
-   }
-}
-
 pair<uint32_t, uint32_t> Population<Symbiont>::pair32Int (uint64_t value) const {
     return pair<uint32_t, uint32_t>((value << 32) >> 32, value >> 32);
 }
 
-uint64_t Population<Symbiont>::genMutation (uint64_t gen, Rng& rng) const {
+ModelGenome::Gen Population<Symbiont>::genMutation (ModelGenome::Gen gen, Rng& rng) const {
    // Determine the number of mutations that occurred in the genotype (nmut)
    int nal = Symbiont::getL() + Symbiont::getL(); // nal is the number of alleles per genotype
    int nmut = rng.binomial( nal , Symbiont::getmutRate() );
    if ( nmut > 0) { // if any mutation occurred
       // Get a vector with randomized indexes from 0 to nal-1:
       std::vector<int> rand_al = rng.randIndexVect ( nal );
-      // Toggle nmut random bits in the genotype using rand_al
+      // Toggle nmut random alleles in the genotype using rand_al
       for ( int i=0; i < nmut ; ++i ) {
-         gen ^= 1ULL << rand_al[ i ];
+         ModelGenome::flipAllele( gen, rand_al[ i ], Symbiont::getL() );
       }
    }
    return (gen);
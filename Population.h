@@ -18,6 +18,8 @@
 #include "SourcePatch.h"
 #include "Gamete.h"
 #include "Param.h"
+#include "MutationScatter.h"
+#include "AlleleCounter.h"
 
 // Forward declarations:
 template<typename T>
@@ -35,12 +37,22 @@ public:
 
    uint64_t newIndFromSource( const SourcePatch&, Rng& );
    uint64_t newBorn( Rng&, Gamete&, Gamete& );
-   T* getInd(uint64_t);
-   const T* getConstInd(uint64_t) const; // variant of getInd for access to individual info without modifying it
+   uint64_t newBorn( Rng&, Gamete&, Gamete&, MutationScatter& ); // variant with the mutations of the reproductive event
+   int getIndex(uint64_t) const; // Index of an individual in the population arrays from its ID (-1 if the ID is no longer alive)
+   T getInd(uint64_t) const; // Copy of an individual from its ID
    void removeInd(uint64_t);
 
+   // Access to the fields of an individual from its ID (the ID must be alive, e.g. the host of a symbiont population)
+   double getPhen(uint64_t) const; // Get the phenotype
+   int getNsymbiont(uint64_t) const; // Get the number of symbionts
+   void setNsymbiont(uint64_t, int); // Set the number of symbionts
+   void addNsymbiont(uint64_t, int); // Add (or remove, if negative) symbionts
+   uint64_t getSPopID(uint64_t) const; // Get the ID of the symbiont population
+   void setSPopID(uint64_t, uint64_t); // Set the ID of the symbiont population
+
    void setPop(const std::vector<T>&);
-   const std::vector<T>& getPop() const;
+   std::vector<T> getPop() const; // Copy of the individuals (the storage is a structure of arrays, see Gens)
+   size_t getCapacity() const; // Maximum number of individuals
 
    void setindList(const std::vector<int>&);
    std::vector<int> getindList() const;
@@ -84,10 +96,18 @@ public:
    std::vector<int> getAlFreq() const; // Get a vector with the frequencies of allele "1" (vector size equals the number of loci). Here, frequency is the total number of alleles "1" present in the population for a given locus (considering the two alleles per locus belonging to each individual in the population).
    double getHexp () const; // Get the expected heterozigosity of the host population based on Hardy-Weinberg equilibrium
    double getHobs () const; // Get the observed heterozigosity of the host population
+   int getSumHetPop () const; // get the sum of heterozigotic loci in the population
 
 
 private:
-   std::vector<T> Pop; // Vector of individuals representing the population
+   // Individuals of the population, as a structure of arrays (individual i is element i of each array and bit i of FemaleBits),
+   // so that the scans of the population and the lookups of the host of a symbiont population read only the field they need
+   std::vector<ModelGenome::Gen> Gens; // Genotypes
+   std::vector<double> Phens; // Phenotypes
+   std::vector<uint64_t> FemaleBits; // Sexes (bit i%64 of word i/64 is set for a female)
+   std::vector<int> Nsymbionts; // Numbers of symbionts inhabiting the individuals
+   std::vector<uint64_t> IDs; // IDs of the individuals
+   std::vector<uint64_t> SPopIDs; // IDs of the symbiont populations inhabiting the individuals
    std::vector<int> indList; // Indirection list to access individuals by id
    std::stack<uint32_t> freeList; // List of free id to use when new individuals are created
    int N; // Number of individuals in the population
@@ -96,13 +116,21 @@ private:
 
    // Utility functions
    std::string PopulationtoString() const;
+   bool isFemale( int i ) const { return ( FemaleBits[ i >> 6 ] >> ( i & 63 ) ) & 1; }
+   void setFemale( int i, bool female ) {
+      uint64_t bit = static_cast<uint64_t>( 1 ) << ( i & 63 );
+      FemaleBits[ i >> 6 ] = female ? ( FemaleBits[ i >> 6 ] | bit ) : ( FemaleBits[ i >> 6 ] & ~bit );
+   }
+   int slot( uint64_t id ) const { return indList[ ( id & 0xFFFFFFFF ) ]; } // Index of a living ID ('id & 0xFFFFFFFF' is the lower 32-bit part of the ID)
+   T indAt( int ) const; // Copy of the individual at an index
+   void setNewInd( uint64_t, const ModelGenome::Gen& ); // Set the sex (a random draw), genotype and phenotype of a new individual
+   void swapInd( int, int ); // Swap two individuals of the population arrays
    uint64_t createInd();
-   uint64_t GenfromGametes(const Gamete&, const Gamete&) const;
+   ModelGenome::Gen GenfromGametes(const Gamete&, const Gamete&) const;
    hgpool produceGametePool( const Patch& , Rng& ) const;
-   void sumAlToAlFreq ( uint32_t , std::vector<int>& ) const;
    std::pair<uint32_t, uint32_t> pair32Int (uint64_t) const;
    int sumHetPop () const;
-   uint64_t genMutation (uint64_t, Rng&) const;
+   ModelGenome::Gen genMutation (ModelGenome::Gen, Rng&) const;
 };
 
 /**** Population class template specialization for Symbiont (member definitions in cpp file) ****/
@@ -119,13 +147,17 @@ public:
    void newIndFromSource( Population<Host>&, const SourcePatch&, Rng& );
    void newLocAdIndFromSource( Population<Host>&, const SourcePatch&, Rng& );
    void newBorn( Population<Host>&, Rng&, Gamete& gamete1, Gamete& gamete2);
+   void newBorn( Population<Host>&, Rng&, Gamete& gamete1, Gamete& gamete2, MutationScatter& ); // variant with the mutations of the reproductive event
    int newImmigrant( Population<Host>& );
    void removeInd(Population<Host>&, int);
 
    void setPop(const std::vector<Symbiont>&);
-   const std::vector<Symbiont>& getPop() const;
+   std::vector<Symbiont> getPop() const; // Copy of the individuals (the storage is a structure of arrays, see Gens)
+   size_t getCapacity() const; // Maximum number of individuals
 
-   Symbiont* getPtrToInd( int );
+   Symbiont getInd( int ) const; // Copy of an individual
+   void setInd( int, const Symbiont& );
+   void swapInd( int, Population<Symbiont>&, int ); // Swap an individual with one of another population (or of the same one). Parameters: index, population and index in that population
 
    void setN(int);
    int getN() const;
@@ -135,6 +167,7 @@ public:
 
    void setID(uint64_t);
    uint64_t getID() const;
+   void resetClassCheck(); // Check the genotype classes at the next reproductive event (the slot holds a new population)
 
    void immigrFromSource( const SourcePatch&, Rng&, Population<Host>& );
 
@@ -147,23 +180,61 @@ public:
    double getSSPhen() const; // Get the average symbiont phenotype
    double getSumPhen() const; // Get the sum of all symbiont phenotypes
    double getDevSPhen( Population<Host>& ) const; // Get the average of the deviation of the mean symbiont phenotype from the host phenotype, relative to the host phenotype (to calculate EvC for symbionts)
-   void getAlFreq( std::vector<int>& ) const;
+   void getAlFreq( std::vector<int>& ) const; // Add the frequencies of allele "1" of the population to a vector (one element per locus)
+   void addAlleles( ModelGenome::Counter& ) const; // Add the genotypes of the population to an allele counter
    int getSumHetPop () const; // get the sum of heterozigotic loci in the population
 
+   // Static member functions
+   static void setGenotypeClasses( bool ); // Set GenotypeClasses
+   static bool getGenotypeClasses(); // Get GenotypeClasses
+
 private:
-   std::vector<Symbiont> Pop; // Vector of individuals representing the population
+   // Within-class type definitions:
+   struct GenClass { // Individuals of the same sex and genotype
+      ModelGenome::Gen Gen; // genotype
+      int Index; // index of one of the individuals (e.g. to compute their phenotype-dependent fecundity)
+      int Count; // number of individuals
+      bool Homozygous; // whether all the gametes of the class are identical
+   };
+
+   // Individuals of the population, as a structure of arrays (individual i is Gens[i], Phens[i] and bit i of FemaleBits),
+   // so that the statistics, the fecundities and the gamete production stream over the field they need
+   std::vector<ModelGenome::Gen> Gens; // Genotypes
+   std::vector<double> Phens; // Phenotypes
+   std::vector<uint64_t> FemaleBits; // Sexes (bit i%64 of word i/64 is set for a female)
    int N; // Number of individuals in the population
    uint64_t PatchID; // id of the host inhabited by the symbiont population
    uint64_t ID; // id of the symbiont population
+   int ClassCheck; // Number of reproductive events before the genotype classes are checked again
 
    // Utility functions
    std::string PopulationtoString() const;
+   bool isFemale( int i ) const { return ( FemaleBits[ i >> 6 ] >> ( i & 63 ) ) & 1; }
+   void setFemale( int i, bool female ) {
+      uint64_t bit = static_cast<uint64_t>( 1 ) << ( i & 63 );
+      FemaleBits[ i >> 6 ] = female ? ( FemaleBits[ i >> 6 ] | bit ) : ( FemaleBits[ i >> 6 ] & ~bit );
+   }
+   void setNewInd( int, const ModelGenome::Gen&, bool ); // Set the sex (a random draw), genotype and (if it is not evaluated in batch) phenotype of a new individual
    int createInd( Population<Host>& );
-   uint64_t GenfromGametes(const Gamete&, const Gamete&) const;
+   ModelGenome::Gen GenfromGametes(const Gamete&, const Gamete&) const;
    gpool produceGametePool( const Population<Host>&, Rng&) const;
-   void sumAlToAlFreq ( uint32_t , std::vector<int>& ) const;
    std::pair<uint32_t, uint32_t> pair32Int (uint64_t) const;
-   uint64_t genMutation (uint64_t, Rng&) const;
+   ModelGenome::Gen genMutation (ModelGenome::Gen, Rng&) const;
+   void batchPhenotypes(); // Phenotypes of all the individuals from the per-locus effect sizes (see LocusEffects)
+   bool buildClasses( bool ); // Group the individuals into genotype classes (if the bool is true, otherwise one class per individual); returns whether the classes are few enough for classReproduction
+   void classReproduction( Population<Host>&, Rng& ); // Reproduction drawing gametes per genotype class, producing only the gametes of the newborns (fast samplers)
+   Gamete classGamete( const GenClass& ) const; // One gamete of an individual of a genotype class
+
+   // Static data
+   static bool GenotypeClasses; // Whether reproduction uses genotype classes when the diversity is low (fast samplers only)
+   static const int ClassRatio = 4; // Minimum number of individuals per genotype class (on average) to reproduce by classes
+   static const int ClassCheckPeriod = 8; // Number of reproductive events without checking the classes after a failed check
+   static std::vector<GenClass> FemaleClasses; // Scratch buffers of classReproduction
+   static std::vector<GenClass> MaleClasses;
+   static std::vector<double> ClassMeans;
+   static std::vector<int> ClassNGametes;
+   static std::vector<int64_t> ClassCumGametes;
+   static std::vector<int> GameteSlots;
 };
 
 
@@ -174,7 +245,7 @@ private:
 
    // Constructor
 template<typename T>
-   Population<T>::Population(const size_t PopVecSize, const std::stack<uint32_t>& frl, int n, uint64_t pid, uint64_t id): Pop(std::vector<T>(PopVecSize)), indList(std::vector<int>(PopVecSize)), freeList(frl), N(n), PatchID(pid), ID(id) {}
+   Population<T>::Population(const size_t PopVecSize, const std::stack<uint32_t>& frl, int n, uint64_t pid, uint64_t id): Gens(PopVecSize), Phens(PopVecSize), FemaleBits( ( PopVecSize + 63 ) / 64 ), Nsymbionts(PopVecSize), IDs(PopVecSize), SPopIDs(PopVecSize), indList(std::vector<int>(PopVecSize)), freeList(frl), N(n), PatchID(pid), ID(id) {}
 
    // Non-static member functions
 
@@ -182,7 +253,6 @@ template<typename T>
    uint64_t Population<T>::newIndFromSource( const SourcePatch& continent, Rng& rng ) {
    // Create new individual and get its id
    uint64_t IDInd = createInd();
-   T* ind = getInd(IDInd);
    // Sample a phenotype value from the continent
    double newPhen = rng.normal( continent.getOptPhen(), continent.getStdPhenH() );
    // Calculate number of 1-bits (k) that would produce the newPhen
@@ -190,13 +260,10 @@ template<typename T>
    double alpha2 = T::getAlpha() + T::getAlpha();
    double kd = l + newPhen/alpha2;
    int k = static_cast<int>(round( kd ));
-   // Get a random 64-bit integer with k 1-bits
-   uint64_t newGen = rng.random_k_bits(k);
+   // Get a random genotype with k alleles "1"
+   ModelGenome::Gen newGen = ModelGenome::randomGen(k, T::getL(), rng);
    // Initialize sex, genotype and phenotype of the new individual:
-   ind->setSex( ( Rng::unif_01() > 0.5 )? 'f' : 'm' );
-   ind->setGen(newGen);
-   ind->Phen_init();
-   ind = nullptr;
+   setNewInd( IDInd, newGen );
    return IDInd;
 }
 
@@ -204,39 +271,62 @@ template<typename T>
    uint64_t Population<T>::newBorn( Rng& rng, Gamete& gamete1, Gamete& gamete2) {
    // Create new individual and get its ID
    uint64_t IDInd = createInd();
-   T* ind = getInd(IDInd);
    // Create a new genotype from the parental gametes
-   uint64_t newGen = GenfromGametes( gamete1, gamete2 );
+   ModelGenome::Gen newGen = GenfromGametes( gamete1, gamete2 );
    // Apply mutation
    if ( T::getmutRate() > 0 ) {
       newGen = genMutation( newGen, rng );
    }
    // Initialize sex, genotype and phenotype of the new individual:
-   ind->setSex( ( Rng::unif_01() > 0.5 )? 'f' : 'm' );
-   ind->setGen(newGen);
-   ind->Phen_init();
+   setNewInd( IDInd, newGen );
+   // Return the new born's ID:
+   return IDInd;
+}
+
+template<typename T> // Variant where the mutations are scattered over all the newborns of the reproductive event
+   uint64_t Population<T>::newBorn( Rng& rng, Gamete& gamete1, Gamete& gamete2, MutationScatter& mutations ) {
+   // Create new individual and get its ID
+   uint64_t IDInd = createInd();
+   // Create a new genotype from the parental gametes and apply its mutations
+   ModelGenome::Gen newGen = GenfromGametes( gamete1, gamete2 );
+   ModelGenome::mutate( newGen, mutations, T::getL(), rng );
+   // Initialize sex, genotype and phenotype of the new individual:
+   setNewInd( IDInd, newGen );
    // Return the new born's ID:
    return IDInd;
 }
 
 template<typename T>
-   T* Population<T>::getInd(uint64_t id) {
+   int Population<T>::getIndex(uint64_t id) const {
    uint32_t index = indList[ (id & 0xFFFFFFFF) ]; // 'id & 0xFFFFFFFF' is the lower 32-bit part of the ID (i.e. the index)
-   if (Pop[index].getID() == id) {
-      return &Pop[index];
+   if (IDs[index] == id) {
+      return static_cast<int>(index);
       }
-   else {return nullptr;}
+   else {return -1;}
 }
 
 template<typename T>
-   const T* Population<T>::getConstInd(uint64_t id) const {
-   uint32_t index = indList[ (id & 0xFFFFFFFF) ]; // 'id & 0xFFFFFFFF' is the lower 32-bit part of the ID (i.e. the index)
-   if (Pop[index].getID() == id) {
-      return &Pop[index];
+   T Population<T>::getInd(uint64_t id) const {
+   int index = getIndex(id);
+   if (index >= 0) {
+      return indAt(index);
       }
-   else {return nullptr;}
+   else {return T();}
 }
 
+template<typename T>
+   double Population<T>::getPhen(uint64_t id) const {return Phens[ slot(id) ];}
+template<typename T>
+   int Population<T>::getNsymbiont(uint64_t id) const {return Nsymbionts[ slot(id) ];}
+template<typename T>
+   void Population<T>::setNsymbiont(uint64_t id, int ns) {Nsymbionts[ slot(id) ] = ns;}
+template<typename T>
+   void Population<T>::addNsymbiont(uint64_t id, int ns) {Nsymbionts[ slot(id) ] += ns;}
+template<typename T>
+   uint64_t Population<T>::getSPopID(uint64_t id) const {return SPopIDs[ slot(id) ];}
+template<typename T>
+   void Population<T>::setSPopID(uint64_t id, uint64_t spopid) {SPopIDs[ slot(id) ] = spopid;}
+
 template<typename T>
    void Population<T>::removeInd(uint64_t id ) {
 //std::cout << "\n\n";
@@ -245,16 +335,16 @@ template<typename T>
 //std::cout << "\nindex part of ID= " << (id & 0xFFFFFFFF);
 //std::cout << "\nIndex obtained from the indlist = " << indList[ (id & 0xFFFFFFFF) ];
 //std::cout << "\nindex = " << index;
-   if (Pop[index].getID() == id) {
+   if (IDs[index] == id) {
       // Update ID
-      Pop[index].setID ( ((Pop[index].getID()) & 0xFFFFFFFF) | ((( Pop[index].getID() >> 32 ) + 1 ) << 32) );
+      IDs[index] = ( (IDs[index]) & 0xFFFFFFFF) | ((( IDs[index] >> 32 ) + 1 ) << 32);
       // Reset NSymbiont and SPopID
-      Pop[index].setNsymbiont ( 0 );
-//      Pop[index].setSPopID ( 0 );
+      Nsymbionts[index] = 0;
+//      SPopIDs[index] = 0;
       // Get the ID of the last living individual in the population vector (to update indlist)
-      uint32_t LastAliveID = Pop[N-1].getID();
+      uint32_t LastAliveID = IDs[N-1];
       // Swap the removed individual with the last living individual in the populaiton vector
-      std::swap(Pop[index],Pop[N-1]);
+      swapInd( index, N-1 );
       // Update the indirection list
       std::swap(indList[(id & 0xFFFFFFFF)], indList[(LastAliveID & 0xFFFFFFFF)]);
       // Return index part of the removed id to the freelist
@@ -267,9 +357,31 @@ template<typename T>
 }
 
 template<typename T>
-   void Population<T>::setPop(const std::vector<T>& pop) { Pop = pop; }
+   void Population<T>::setPop(const std::vector<T>& pop) {
+   Gens.resize( pop.size() );
+   Phens.resize( pop.size() );
+   FemaleBits.assign( ( pop.size() + 63 ) / 64, 0 );
+   Nsymbionts.resize( pop.size() );
+   IDs.resize( pop.size() );
+   SPopIDs.resize( pop.size() );
+   for ( size_t i = 0; i < pop.size(); ++i ) {
+      Gens[i] = pop[i].getGen();
+      Phens[i] = pop[i].getPhen();
+      setFemale( static_cast<int>( i ), pop[i].getSex() == 'f' );
+      Nsymbionts[i] = pop[i].getNsymbiont();
+      IDs[i] = pop[i].getID();
+      SPopIDs[i] = pop[i].getSPopID();
+   }
+}
+template<typename T>
+   std::vector<T> Population<T>::getPop() const {
+   std::vector<T> pop;
+   pop.reserve( Gens.size() );
+   for ( size_t i = 0; i < Gens.size(); ++i ) { pop.push_back( indAt( static_cast<int>( i ) ) ); }
+   return pop;
+}
 template<typename T>
-   const std::vector<T>& Population<T>::getPop() const {return Pop;}
+   size_t Population<T>::getCapacity() const {return Gens.size();}
 
 template<typename T>
    void Population<T>::setindList(const std::vector<int>& inl) {indList = inl;}
@@ -321,8 +433,8 @@ void Population<T>::initImmigrFromSource( const SourcePatch& continent, Rng& rng
    while ( n_ind == 0 ) { // To sample an n_ind > 0
       n_ind = rng.poisson( continent.getHNmigrants() );
    }
-   if ( n_ind > static_cast<int>(getPop().size()) ) { // To prevent from Pop vector overflow
-      n_ind = static_cast<int>(getPop().size());
+   if ( n_ind > static_cast<int>(getCapacity()) ) { // To prevent from Pop vector overflow
+      n_ind = static_cast<int>(getCapacity());
    }
    // Create the new source individuals
    for ( int counter = 0; counter < n_ind; ++counter ) {
@@ -337,8 +449,8 @@ void Population<T>::immigrFromSource( const SourcePatch& continent, Rng& rng, Me
    int n_ind = rng.poisson( continent.getHNmigrants() );
    // Notice that here we do not use: while ( n_ind == 0 ) { n_ind = rng.poisson( continent.getHNmigrants() );}
    // This is because we allow n_ind = 0 for an event of periodic migration
-   if ( n_ind > static_cast<int>(getPop().size()) ) { // To prevent from Pop vector overflow
-      n_ind = static_cast<int>(getPop().size());
+   if ( n_ind > static_cast<int>(getCapacity()) ) { // To prevent from Pop vector overflow
+      n_ind = static_cast<int>(getCapacity());
    }
    // Create the new source individuals
    if ( n_ind > 0 ) { // because in this function n_ind can be 0
@@ -359,8 +471,8 @@ void Population<T>::pulseImmigrFromSource( const SourcePatch& continent, Rng& rn
       while ( n_ind == 0 ) { // To sample an n_ind > 0
          n_ind = rng.poisson( continent.getHNmigrants() );
       }
-      if ( n_ind > static_cast<int>(getPop().size()) ) { // To prevent from Pop vector overflow
-         n_ind = static_cast<int>(getPop().size());
+      if ( n_ind > static_cast<int>(getCapacity()) ) { // To prevent from Pop vector overflow
+         n_ind = static_cast<int>(getCapacity());
       }
       // Create the new source individuals
       for ( int counter = 0; counter < n_ind; ++counter ) {
@@ -387,9 +499,11 @@ void Population<T>::popReproduction ( const Patch& island, Rng& rng, Metapopulat
 //std::cout << "\n\nSize of female gamPool = " << gamPool.first.size();
 //std::cout << "\n\nSize of male gamPool = " << gamPool.second.size();
       if ( NnewBorn > 0 ) { // If we have newborns
+         MutationScatter mutations( T::getmutRate() ); // mutations of all the newborns (fast samplers only)
          for ( int i = 0; i < NnewBorn; ++i ) { // For each newborn
             // Create a newborn host and get its ID
-            uint64_t newbornID = newBorn( rng, gamPool.first[randgF[i]], gamPool.second[randgM[i]] );
+            uint64_t newbornID = Rng::getLegacy() ? newBorn( rng, gamPool.first[randgF[i]], gamPool.second[randgM[i]] )
+               : newBorn( rng, gamPool.first[randgF[i]], gamPool.second[randgM[i]], mutations );
             // Create an empty symbiont population in the newborn host and gets its ID
             uint64_t nbSpopID = smpop.newBornPop(*this, newbornID);
             // Get IDs of parental hosts
@@ -419,8 +533,8 @@ void Population<T>::popMortality ( Rng& rng, Metapopulation<Population<Symbiont>
 //std::cout << "\nN = " << N;
 //std::cout << "\nindexDeadHost = " << indexDeadHost;
       // Get the ID of the host and its associated symbiont population
-      int64_t deadHostID = Pop[ indexDeadHost ].getID();
-      int64_t deadSPopID = Pop[ indexDeadHost ].getSPopID();
+      int64_t deadHostID = IDs[ indexDeadHost ];
+      int64_t deadSPopID = SPopIDs[ indexDeadHost ];
 //std::cout << "\nindex part of deadHostID= " << (deadHostID & 0xFFFFFFFF);
       // Remove the host and its associated symbiont population
       removeInd(deadHostID);
@@ -431,7 +545,7 @@ void Population<T>::popMortality ( Rng& rng, Metapopulation<Population<Symbiont>
 template<typename T>
 void Population<T>::printIndividuals () const {
    for (int counter = 0; counter < N; ++counter) {
-   Pop[counter].printIndividual();
+   indAt(counter).printIndividual();
    }
 }
 
@@ -453,7 +567,7 @@ double Population<T>::getSPrev () const {
    if (N>0) {
       int OccupHosts = 0;
       for (int counter = 0; counter < N; ++counter) {
-         if (Pop[counter].getNsymbiont() > 0) { ++OccupHosts; }
+         if (Nsymbionts[counter] > 0) { ++OccupHosts; }
       }
       return ( static_cast<double>(OccupHosts)/static_cast<double>(N) );
    }
@@ -466,9 +580,9 @@ double Population<T>::getAvSAbOcH() const {
       int OccupHosts = 0;
       int TotalSAb = 0;
       for (int counter = 0; counter < N; ++counter) {
-         if (Pop[counter].getNsymbiont() > 0) {
+         if (Nsymbionts[counter] > 0) {
             ++OccupHosts;
-            TotalSAb += Pop[counter].getNsymbiont();
+            TotalSAb += Nsymbionts[counter];
          }
       }
       if ( OccupHosts>0 ) { return ( static_cast<double>(TotalSAb) / static_cast<double>(OccupHosts) ); }
@@ -482,7 +596,7 @@ double Population<T>::getAvSAb() const {
    if (N>0) {
       int TotalSAb = 0;
       for (int counter = 0; counter < N; ++counter) {
-         TotalSAb += Pop[counter].getNsymbiont();
+         TotalSAb += Nsymbionts[counter];
       }
       return ( static_cast<double>(TotalSAb) / static_cast<double>(N) );
    }
@@ -496,7 +610,7 @@ double Population<T>::getVarSAb() const {
       if ( mean > 0 ) {
          double var = 0;
          for (int counter = 0; counter < N; ++counter) {
-            var += pow( ( static_cast<double>(Pop[counter].getNsymbiont()) - mean ), 2) ;
+            var += pow( ( static_cast<double>(Nsymbionts[counter]) - mean ), 2) ;
          }
          return ( var );
       }
@@ -512,7 +626,7 @@ double Population<T>::getStdSAb() const {
       if ( mean > 0 ) {
          double var = 0;
          for (int counter = 0; counter < N; ++counter) {
-            var += pow( ( static_cast<double>(Pop[counter].getNsymbiont()) - mean ), 2) ;
+            var += pow( ( static_cast<double>(Nsymbionts[counter]) - mean ), 2) ;
          }
          return ( sqrt(var) );
       }
@@ -552,7 +666,7 @@ double Population<T>::getAvHPhen() const {
    if (N>0) {
       double SumPhen = 0;
       for (int counter = 0; counter < N; ++counter) {
-         SumPhen += Pop[counter].getPhen();
+         SumPhen += Phens[counter];
       }
       return ( SumPhen / static_cast<double>(N) );
    }
@@ -565,7 +679,7 @@ double Population<T>::getStdHPhen() const {
       double mean = getAvHPhen();
       double var = 0;
       for (int counter = 0; counter < N; ++counter) {
-         var += pow( ( Pop[counter].getPhen() - mean ), 2) ;
+         var += pow( ( Phens[counter] - mean ), 2) ;
       }
       return ( sqrt(var) );
    }
@@ -589,11 +703,11 @@ template<typename T>
 std::vector<int> Population<T>::getAlFreq() const {
    std::vector<int> alfreq( Host::getL() );
    if ( N > 0 ) {
+      ModelGenome::Counter alleles; // counts both haplotypes of each genotype
       for ( int counter = 0; counter < N; ++counter ) {
-         std::pair<uint32_t, uint32_t> pairgen = pair32Int( Pop[counter].getGen() );
-         sumAlToAlFreq( pairgen.first, alfreq );
-         sumAlToAlFreq( pairgen.second, alfreq );
+         alleles.add( Gens[counter] );
       }
+      alleles.addTo( alfreq );
    }
    return alfreq;
 }
@@ -606,6 +720,9 @@ double Population<T>::getHobs () const {
    return ( sumhetpop / ( n * l ) );
 }
 
+template<typename T>
+int Population<T>::getSumHetPop () const { return( sumHetPop() ); }
+
    // Utility functions
 
 template<typename T>
@@ -624,8 +741,8 @@ template<typename T>
    if (!freeList.empty()) {
       uint32_t newID = freeList.top(); // freeList elements are uint32_t
       freeList.pop();
-      Pop[N].setID (static_cast<uint64_t>(newID) | ((( Pop[N].getID() >> 32 ) + 1 ) << 32)); // set the ID's lower32 part (ie. the index) equal to newID, and increment by 1 the upper32 part (i.e. the version)
-      uint64_t newID64 = Pop[N].getID();
+      IDs[N] = static_cast<uint64_t>(newID) | ((( IDs[N] >> 32 ) + 1 ) << 32); // set the ID's lower32 part (ie. the index) equal to newID, and increment by 1 the upper32 part (i.e. the version)
+      uint64_t newID64 = IDs[N];
       indList[newID] = N;
       ++N;
       return newID64;
@@ -637,10 +754,9 @@ template<typename T>
 }
 
 template<typename T>
-   uint64_t Population<T>::GenfromGametes(const Gamete& gamete1, const Gamete& gamete2) const {
-   // (uint64_t) mostSignificantWord << 32 | leastSignificantWord
-   uint64_t newGen = (uint64_t) gamete1.getHaplGen() << 32 | gamete2.getHaplGen();
-   return(newGen);
+   ModelGenome::Gen Population<T>::GenfromGametes(const Gamete& gamete1, const Gamete& gamete2) const {
+   // the haplotype of gamete1 is the upper one (see Genome)
+   return( ModelGenome::fromGametes( gamete1.getHaplGen(), gamete2.getHaplGen() ) );
 }
 
 template<typename T> // Function for host populations
@@ -650,31 +766,15 @@ typename Population<T>::hgpool Population<T>::produceGametePool( const Patch& is
    FemaleGam.reserve(island.getKhost());
    MaleGam.reserve(island.getKhost());
    for ( int i = 0; i < N; ++i ) {
-      std::vector<HostGamete> GamInd = Pop[i].produceGametes( island, N, rng );
-      if ( Pop[i].getSex() == 'f' ) {
-         FemaleGam.insert( FemaleGam.end(), GamInd.begin(),GamInd.end());
-//std::cout << "Added to female pool: " << GamInd.size() << " gametes\n";
-//for (const auto& i:GamInd) {i.printHaplGen();}
-      }
-      else {
-         MaleGam.insert( MaleGam.end(), GamInd.begin(),GamInd.end());
-//std::cout << "Added to male pool: " << GamInd.size() << " gametes\n";
-//for (const auto& i:GamInd) {i.printHaplGen();}
-      }
+      Rng::setEntity( IDs[i] & 0xFFFFFFFF ); // substream of the host (stream mode)
+      int ngametes = rng.poisson( T::meanNGametes( Phens[i], Nsymbionts[i], island, N ) );
+      std::vector<HostGamete>& GamPool = isFemale( i ) ? FemaleGam : MaleGam;
+      for ( int g = 0; g < ngametes; ++g ) { GamPool.push_back( HostGamete( Organism::createHaplGen( Gens[i] ), IDs[i] ) ); }
    }
+   Rng::setEntity( Rng::PopEntity ); // back to the population substream (stream mode)
    return (std::pair<std::vector<HostGamete>,std::vector<HostGamete>>( FemaleGam, MaleGam ));
 }
 
-template<typename T>
-void Population<T>::sumAlToAlFreq ( uint32_t haplgen , std::vector<int>& alfrq ) const {
-   const uint32_t SHIFT{8 * sizeof(uint32_t) - 1};
-   const uint32_t MASK{static_cast<const uint32_t>(1 << SHIFT)};
-   for (uint32_t i{1}; i <= SHIFT + 1; ++i) {
-      if (haplgen & MASK) {++alfrq[i-1];}
-      haplgen <<= 1; // shift haplgen left by 1
-   }
-}
-
 template<typename T>
 std::pair<uint32_t, uint32_t> Population<T>::pair32Int (uint64_t value) const {
     return std::pair<uint32_t, uint32_t>((value << 32) >> 32, value >> 32);
@@ -682,24 +782,46 @@ std::pair<uint32_t, uint32_t> Population<T>::pair32Int (uint64_t value) const {
 
 template<typename T>
 int Population<T>::sumHetPop () const {
-   int sumhetpop = 0;
-   for ( int i=0; i < N ; ++i ) {
-      sumhetpop += Pop[i].sumHetLocInd();
-   }
-   return(sumhetpop);
+   // The genotypes are contiguous: heterozygosity kernel over the whole array (one popcount per two individuals)
+   return( static_cast<int>( Organism::sumHetLoc( Gens.data(), static_cast<size_t>( N ) ) ) );
+}
+
+template<typename T>
+T Population<T>::indAt( int index ) const {
+   return T( isFemale( index ) ? 'f' : 'm', Gens[index], Phens[index], Nsymbionts[index], IDs[index], SPopIDs[index] );
+}
+
+template<typename T>
+void Population<T>::setNewInd( uint64_t id, const ModelGenome::Gen& gen ) {
+   int index = slot( id );
+   setFemale( index, Rng::unif_01() > 0.5 );
+   Gens[index] = gen;
+   Phens[index] = Organism::phenotype( gen );
+}
+
+template<typename T>
+void Population<T>::swapInd( int index1, int index2 ) {
+   std::swap( Gens[index1], Gens[index2] );
+   std::swap( Phens[index1], Phens[index2] );
+   bool female = isFemale( index1 );
+   setFemale( index1, isFemale( index2 ) );
+   setFemale( index2, female );
+   std::swap( Nsymbionts[index1], Nsymbionts[index2] );
+   std::swap( IDs[index1], IDs[index2] );
+   std::swap( SPopIDs[index1], SPopIDs[index2] );
 }
 
 template<typename T>
-uint64_t Population<T>::genMutation (uint64_t gen, Rng& rng) const {
+ModelGenome::Gen Population<T>::genMutation (ModelGenome::Gen gen, Rng& rng) const {
    // Determine the number of mutations that occurred in the genotype (nmut)
    int nal = T::getL() + T::getL(); // nal is the number of alleles per genotype
    int nmut = rng.binomial( nal , T::getmutRate() );
    if ( nmut > 0) { // if any mutation occurred
       // Get a vector with randomized indexes from 0 to nal-1:
       std::vector<int> rand_al = rng.randIndexVect ( nal );
-      // Toggle nmut random bits in the genotype using rand_al
+      // Toggle nmut random alleles in the genotype using rand_al
       for ( int i=0; i < nmut ; ++i ) {
-         gen ^= 1ULL << rand_al[ i ];
+         ModelGenome::flipAllele( gen, rand_al[ i ], T::getL() );
       }
    }
    return (gen);
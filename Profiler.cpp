@@ -0,0 +1,257 @@
+// Implementation of Profiler class
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <string>
+#include <iomanip>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <vector> // C++ standard vector class template
+#include "Profiler.h"
+#include "AllocStats.h"
+#include "PerfCounters.h"
+#include "Simul.h"
+#include "json.hpp"
+
+using json = nlohmann::json;
+using namespace std;
+using namespace std::chrono;
+
+// ---Static member functions---
+
+void Profiler::setEnabled( bool enabled ) { Enabled = enabled; }
+bool Profiler::getEnabled() {return Enabled;}
+
+void Profiler::setAllocEnabled( bool allocenabled ) { AllocEnabled = allocenabled; }
+bool Profiler::getAllocEnabled() {return AllocEnabled;}
+
+void Profiler::setPerfEnabled( bool perfenabled ) { PerfEnabled = perfenabled; }
+bool Profiler::getPerfEnabled() {return PerfEnabled;}
+
+void Profiler::start( Phase phase ) {
+   if ( !Enabled && !AllocEnabled && !PerfEnabled ) { return; }
+   if ( AllocEnabled ) {
+      StartAllocs[phase] = AllocStats::getNAllocs();
+      StartBytes[phase] = AllocStats::getNBytes();
+   }
+   StartTime[phase] = steady_clock::now();
+   if ( PerfEnabled ) { PerfCounters::read( StartCount[phase] ); } // last, so that the phase is measured alone
+}
+
+void Profiler::stop( Phase phase ) {
+   if ( !Enabled && !AllocEnabled && !PerfEnabled ) { return; }
+   if ( PerfEnabled ) { // first, so that the phase is measured alone
+      uint64_t count[PerfCounters::NCounters];
+      PerfCounters::read( count );
+      for ( int counter = 0; counter < PerfCounters::NCounters; ++counter ) {
+         TotalCount[phase][counter] += count[counter] - StartCount[phase][counter];
+      }
+   }
+   uint64_t ns = static_cast<uint64_t>( duration_cast<nanoseconds>( steady_clock::now() - StartTime[phase] ).count() );
+   ++NCalls[phase];
+   TotalNs[phase] += ns;
+   if ( ns < MinNs[phase] ) { MinNs[phase] = ns; }
+   if ( ns > MaxNs[phase] ) { MaxNs[phase] = ns; }
+   ++Hist[phase][getBin(ns)];
+   if ( AllocEnabled ) {
+      uint64_t nallocs = AllocStats::getNAllocs() - StartAllocs[phase];
+      uint64_t nbytes = AllocStats::getNBytes() - StartBytes[phase];
+      TotalAllocs[phase] += nallocs;
+      TotalBytes[phase] += nbytes;
+      YearAllocs[phase] += nallocs;
+      YearBytes[phase] += nbytes;
+   }
+}
+
+void Profiler::init() {
+   reset();
+   if ( PerfEnabled && !PerfCounters::open() ) {
+      cerr << "Warning: the profile will not include hardware performance counters" << endl;
+      PerfEnabled = false;
+   }
+   if ( !AllocEnabled ) { return; }
+   std::string replid = std::to_string( Simul::getReplID() );
+   AllocFile.open("output_full/alloc" + Simul::getScenID() + "_" + replid + ".csv");
+   if( !AllocFile ) { // file couldn't be opened
+      cerr << "Error: allocation report file could not be opened" << endl;
+      return;
+   }
+   AllocFile << "Scenario ID" << ","
+      << "Replicate ID" << ","
+      << "Year" << ","
+      << "Phase" << ","
+      << "NAllocs" << ","
+      << "NBytes" << "\n";
+}
+
+void Profiler::printYear( int year ) {
+   if ( !AllocEnabled ) { return; }
+   for ( int phase = 0; phase < NPhases; ++phase ) {
+      AllocFile << Simul::getScenID() << ","
+         << Simul::getReplID() << ","
+         << year << ","
+         << getPhaseName( static_cast<Phase>(phase) ) << ","
+         << YearAllocs[phase] << ","
+         << YearBytes[phase] << "\n";
+      YearAllocs[phase] = 0;
+      YearBytes[phase] = 0;
+   }
+}
+
+void Profiler::reset() {
+   for ( int phase = 0; phase < NPhases; ++phase ) {
+      NCalls[phase] = 0;
+      TotalNs[phase] = 0;
+      MinNs[phase] = UINT64_MAX;
+      MaxNs[phase] = 0;
+      for ( int bin = 0; bin < NBins; ++bin ) { Hist[phase][bin] = 0; }
+      TotalAllocs[phase] = 0;
+      TotalBytes[phase] = 0;
+      YearAllocs[phase] = 0;
+      YearBytes[phase] = 0;
+      for ( int counter = 0; counter < PerfCounters::NCounters; ++counter ) { TotalCount[phase][counter] = 0; }
+   }
+}
+
+void Profiler::printProfile() {
+   if ( AllocFile.is_open() ) { AllocFile.close(); }
+   if ( PerfCounters::isOpen() ) { PerfCounters::close(); }
+   if ( !Enabled && !PerfEnabled ) { return; }
+   std::string replid = std::to_string( Simul::getReplID() );
+   ofstream fsummary("output_full/profile" + Simul::getScenID() + "_" + replid + ".csv");
+   if( !fsummary ) { // file couldn't be opened
+      cerr << "Error: profile summary file could not be opened" << endl;
+      return;
+   }
+   printSummary( fsummary );
+   ofstream fjson("output_full/profile" + Simul::getScenID() + "_" + replid + ".JSON");
+   if( !fjson ) { // file couldn't be opened
+      cerr << "Error: profile JSON file could not be opened" << endl;
+      return;
+   }
+   printJson( fjson );
+}
+
+string Profiler::getPhaseName( Phase phase ) {
+   switch ( phase ) {
+      case PhaseHorizTrans: return "horizTrans";
+      case PhaseSReproduction: return "metapopReproduction";
+      case PhaseHReproduction: return "popReproduction";
+      case PhaseHMortality: return "popMortality";
+      case PhaseHImmigration: return "immigrFromSource";
+      case PhaseOutput: return "printDataToFiles";
+      default: return "unknown";
+   }
+}
+
+uint64_t Profiler::getNCalls( Phase phase ) {return NCalls[phase];}
+uint64_t Profiler::getTotalNs( Phase phase ) {return TotalNs[phase];}
+uint64_t Profiler::getTotalAllocs( Phase phase ) {return TotalAllocs[phase];}
+uint64_t Profiler::getTotalBytes( Phase phase ) {return TotalBytes[phase];}
+uint64_t Profiler::getTotalCount( Phase phase, PerfCounters::Counter counter ) {return TotalCount[phase][counter];}
+
+// ---Utility functions---
+
+int Profiler::getBin( uint64_t ns ) {
+   int bin = 0;
+   while ( ns > 1 && bin < NBins - 1 ) { // floor(log2(ns)), capped at the last bin
+      ns >>= 1;
+      ++bin;
+   }
+   return bin;
+}
+
+void Profiler::printSummary( ofstream& outf ) {
+   uint64_t totalNsAll = 0;
+   for ( int phase = 0; phase < NPhases; ++phase ) { totalNsAll += TotalNs[phase]; }
+   outf << "Scenario ID" << ","
+      << "Replicate ID" << ","
+      << "Phase" << ","
+      << "NCalls" << ","
+      << "TotalSeconds" << ","
+      << "MeanMicroseconds" << ","
+      << "MinMicroseconds" << ","
+      << "MaxMicroseconds" << ","
+      << "Share" << ","
+      << "NAllocs" << ","
+      << "NBytes";
+   if ( PerfEnabled ) {
+      for ( int counter = 0; counter < PerfCounters::NCounters; ++counter ) {
+         outf << "," << PerfCounters::getCounterName( static_cast<PerfCounters::Counter>(counter) );
+      }
+      outf << "," << "IPC";
+   }
+   outf << "\n";
+   for ( int phase = 0; phase < NPhases; ++phase ) {
+      double ncalls = static_cast<double>( NCalls[phase] );
+      double total = static_cast<double>( TotalNs[phase] );
+      outf << Simul::getScenID() << ","
+         << Simul::getReplID() << ","
+         << getPhaseName( static_cast<Phase>(phase) ) << ","
+         << NCalls[phase] << ","
+         << total * 1e-9 << ","
+         << ( ( NCalls[phase] > 0 ) ? total / ncalls * 1e-3 : 0 ) << ","
+         << ( ( NCalls[phase] > 0 ) ? static_cast<double>( MinNs[phase] ) * 1e-3 : 0 ) << ","
+         << static_cast<double>( MaxNs[phase] ) * 1e-3 << ","
+         << ( ( totalNsAll > 0 ) ? total / static_cast<double>( totalNsAll ) : 0 ) << ","
+         << TotalAllocs[phase] << ","
+         << TotalBytes[phase];
+      if ( PerfEnabled ) {
+         for ( int counter = 0; counter < PerfCounters::NCounters; ++counter ) { outf << "," << TotalCount[phase][counter]; }
+         uint64_t cycles = TotalCount[phase][PerfCounters::CounterCycles];
+         uint64_t instructions = TotalCount[phase][PerfCounters::CounterInstructions];
+         outf << "," << ( ( cycles > 0 ) ? static_cast<double>( instructions ) / static_cast<double>( cycles ) : 0 );
+      }
+      outf << "\n";
+   }
+}
+
+void Profiler::printJson( ofstream& outf ) {
+   json profile;
+   profile[ "ScenID" ] = Simul::getScenID();
+   profile[ "ReplID" ] = Simul::getReplID();
+   profile[ "HistBins" ] = "bin i counts calls lasting [2^i, 2^(i+1)) ns";
+   for ( int phase = 0; phase < NPhases; ++phase ) {
+      json jphase;
+      jphase[ "Name" ] = getPhaseName( static_cast<Phase>(phase) );
+      jphase[ "NCalls" ] = NCalls[phase];
+      jphase[ "TotalNs" ] = TotalNs[phase];
+      jphase[ "MinNs" ] = ( NCalls[phase] > 0 ) ? MinNs[phase] : 0;
+      jphase[ "MaxNs" ] = MaxNs[phase];
+      jphase[ "NAllocs" ] = TotalAllocs[phase];
+      jphase[ "NBytes" ] = TotalBytes[phase];
+      if ( PerfEnabled ) {
+         for ( int counter = 0; counter < PerfCounters::NCounters; ++counter ) {
+            jphase[ PerfCounters::getCounterName( static_cast<PerfCounters::Counter>(counter) ) ] = TotalCount[phase][counter];
+         }
+      }
+      jphase[ "Hist" ] = std::vector<uint64_t>( Hist[phase], Hist[phase] + NBins );
+      profile[ "Phases" ].push_back( jphase );
+   }
+   outf << std::setw(3) << profile << "\n";
+}
+
+// ---Static data members---
+bool Profiler::Enabled = false;
+bool Profiler::AllocEnabled = false;
+bool Profiler::PerfEnabled = false;
+steady_clock::time_point Profiler::StartTime[NPhases];
+uint64_t Profiler::NCalls[NPhases] = {};
+uint64_t Profiler::TotalNs[NPhases] = {};
+uint64_t Profiler::MinNs[NPhases] = {}; // set to UINT64_MAX by reset()
+uint64_t Profiler::MaxNs[NPhases] = {};
+uint64_t Profiler::Hist[NPhases][NBins] = {};
+uint64_t Profiler::StartAllocs[NPhases] = {};
+uint64_t Profiler::StartBytes[NPhases] = {};
+uint64_t Profiler::TotalAllocs[NPhases] = {};
+uint64_t Profiler::TotalBytes[NPhases] = {};
+uint64_t Profiler::YearAllocs[NPhases] = {};
+uint64_t Profiler::YearBytes[NPhases] = {};
+uint64_t Profiler::StartCount[NPhases][PerfCounters::NCounters] = {};
+uint64_t Profiler::TotalCount[NPhases][PerfCounters::NCounters] = {};
+ofstream Profiler::AllocFile;
+
+// ---Constructor---
+
+Profiler::Profiler() {}
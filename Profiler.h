@@ -0,0 +1,96 @@
+// Profiler class definition
+
+/* Opt-in wall-clock profiler for the phases of the main loop in Simul::runSimul.
+   Each phase is timed per step with a monotonic clock (std::chrono::steady_clock),
+   and the durations are accumulated into a per-phase summary and a log2 histogram.
+   The profile is written next to output1 (output_full/) at the end of the run:
+      profile<ScenID>_<ReplID>.csv  = one summary row per phase
+      profile<ScenID>_<ReplID>.JSON = summary plus histogram of durations per phase
+   Optionally, the hardware performance counters of the process (see PerfCounters) are read around
+   each phase too, and their counts are added to both files.
+   Optionally, the heap allocations made during each phase (counted by AllocStats) are accumulated
+   too, and reported per output year into output_full/alloc<ScenID>_<ReplID>.csv.
+   When the profiler is disabled (default), start() and stop() return immediately.
+*/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <string>
+#include <chrono>
+#include <fstream>
+#include "PerfCounters.h"
+
+class Profiler {
+public:
+
+   // Phases of the main simulation loop
+   enum Phase {
+      PhaseHorizTrans = 0, // smpop.horizTrans
+      PhaseSReproduction, // smpop.metapopReproduction
+      PhaseHReproduction, // hpop.popReproduction
+      PhaseHMortality, // hpop.popMortality
+      PhaseHImmigration, // hpop.immigrFromSource
+      PhaseOutput, // Output::printDataToFiles
+      NPhases // number of phases (not a phase)
+   };
+
+   static const int NBins = 40; // Number of histogram bins; bin i counts durations in [2^i, 2^(i+1)) nanoseconds
+
+   Profiler(); // constructor
+
+   // Static member functions
+
+   static void setEnabled( bool ); // Set Enabled
+   static bool getEnabled(); // Get Enabled
+
+   static void setAllocEnabled( bool ); // Set AllocEnabled
+   static bool getAllocEnabled(); // Get AllocEnabled
+
+   static void setPerfEnabled( bool ); // Set PerfEnabled
+   static bool getPerfEnabled(); // Get PerfEnabled
+
+   static void start( Phase ); // Start timing a phase
+   static void stop( Phase ); // Stop timing a phase and accumulate its duration
+
+   static void init(); // Reset all accumulated data, open the allocation report and the performance counters
+   static void reset(); // Reset all accumulated data
+   static void printYear( int ); // Write the allocations of the current output year and reset them
+   static void printProfile(); // Write the profile files into output_full/
+
+   static std::string getPhaseName( Phase ); // Get the name of a phase
+   static uint64_t getNCalls( Phase ); // Get the number of timed calls of a phase
+   static uint64_t getTotalNs( Phase ); // Get the total duration of a phase (in nanoseconds)
+   static uint64_t getTotalAllocs( Phase ); // Get the total number of heap allocations of a phase
+   static uint64_t getTotalBytes( Phase ); // Get the total number of allocated bytes of a phase
+   static uint64_t getTotalCount( Phase, PerfCounters::Counter ); // Get the total count of a hardware counter in a phase
+
+private:
+
+   static bool Enabled; // Whether the profiler is active
+   static bool AllocEnabled; // Whether heap allocations are accounted per phase
+   static bool PerfEnabled; // Whether hardware performance counters are accounted per phase
+   static std::chrono::steady_clock::time_point StartTime[NPhases]; // Start time of the current call of each phase
+   static uint64_t NCalls[NPhases]; // Number of timed calls per phase
+   static uint64_t TotalNs[NPhases]; // Total duration per phase (ns)
+   static uint64_t MinNs[NPhases]; // Shortest call per phase (ns)
+   static uint64_t MaxNs[NPhases]; // Longest call per phase (ns)
+   static uint64_t Hist[NPhases][NBins]; // Histogram of call durations per phase
+   static uint64_t StartAllocs[NPhases]; // Allocation counter at the start of the current call of each phase
+   static uint64_t StartBytes[NPhases]; // Allocated-bytes counter at the start of the current call of each phase
+   static uint64_t TotalAllocs[NPhases]; // Total number of allocations per phase
+   static uint64_t TotalBytes[NPhases]; // Total number of allocated bytes per phase
+   static uint64_t YearAllocs[NPhases]; // Number of allocations per phase in the current output year
+   static uint64_t YearBytes[NPhases]; // Number of allocated bytes per phase in the current output year
+   static uint64_t StartCount[NPhases][PerfCounters::NCounters]; // Hardware counters at the start of the current call of each phase
+   static uint64_t TotalCount[NPhases][PerfCounters::NCounters]; // Total hardware counts per phase
+   static std::ofstream AllocFile; // Allocation report (one row per output year and phase)
+
+   // Utility functions
+   static int getBin( uint64_t ); // Get the histogram bin of a duration (ns)
+   static void printSummary( std::ofstream& ); // Print the CSV summary
+   static void printJson( std::ofstream& ); // Print the JSON profile
+   };
+
+   #endif // PROFILER_H
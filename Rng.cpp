@@ -4,7 +4,13 @@
 #include<random>
 #include<algorithm>
 #include <fstream>
+#include <sstream>
+#include <vector>
 #include <array>
+#include <cmath>
+#include <cstring> // memcpy() function
+#include <cstdlib> // exit() function
+#include <iostream>
 #include "Rng.h"
 #include <boost/math/distributions/negative_binomial.hpp> // Boost version of negative binomial dist*
 #include "Simul.h"
@@ -14,15 +20,142 @@ using namespace std;
 
 // ---Static data members---
 // Static data members should be defined and initialized in the cpp. file
-mt19937 Rng::Rng_engine;  // use thread_local here in a multithreading context
+RngEngineType Rng::Rng_engine;  // use thread_local here in a multithreading context
+Philox4x32 Rng::Rng_stream; // use thread_local here in a multithreading context
+Rng::Engine Rng::Rng_urbg;
+bool Rng::StreamMode = false;
+uint64_t Rng::Seed = 0;
+uint32_t Rng::CurrStep = 0;
+Rng::StreamPhase Rng::CurrPhase = Rng::StreamInit;
+bool Rng::Legacy = true;
+bool Rng::FromSeed = false;
+bool Rng::BinaryState = false;
+Rng::PoissonTable Rng::PoissonTables[PoissonNTables] = {
+   {-1,0,0,{}}, {-1,0,0,{}}, {-1,0,0,{}}, {-1,0,0,{}}, {-1,0,0,{}}, {-1,0,0,{}}, {-1,0,0,{}}, {-1,0,0,{}},
+   {-1,0,0,{}}, {-1,0,0,{}}, {-1,0,0,{}}, {-1,0,0,{}}, {-1,0,0,{}}, {-1,0,0,{}}, {-1,0,0,{}}, {-1,0,0,{}} };
+Rng::PoissonPtrs Rng::PoissonPtrsCache = {-1,0,0,0,0,0,0};
+BinomialSampler Rng::BinomialSamplers[BinomialNSamplers];
+uint32_t Rng::BitsBuffer[BitsBlockSize];
+int Rng::BitsPos = BitsBlockSize;
+
+// ---Utility functions (file scope)---
+
+// splitmix64 finaliser of a 64-bit value
+static uint64_t mix64( uint64_t z ) {
+   z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9;
+   z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EB;
+   return ( z ^ ( z >> 31 ) );
+}
+
+// Engine of a replicate derived from the master seed (one version per engine)
+#if defined(RNG_XOSHIRO256)
+static void seedReplicate( Xoshiro256ss& engine, uint64_t seed, uint64_t replid ) {
+   engine.seed( seed );
+   for ( uint64_t i = 0; i < replid; ++i ) { engine.jump(); } // replicates are 2^128 steps apart
+}
+#elif defined(RNG_PCG64)
+static void seedReplicate( Pcg64& engine, uint64_t seed, uint64_t replid ) {
+   // One PCG stream (increment) per replicate
+   Pcg64::uint128 initstate = static_cast<Pcg64::uint128>( mix64( seed ) ) << 64 | mix64( ~seed );
+   engine.seed( initstate, replid );
+}
+#else
+static void seedReplicate( std::mt19937& engine, uint64_t seed, uint64_t replid ) {
+   // No cheap jump-ahead for mt19937: distinct seed sequences give statistically independent states
+   seed_seq seq{ static_cast<uint32_t>( seed ), static_cast<uint32_t>( seed >> 32 ),
+      static_cast<uint32_t>( replid ), static_cast<uint32_t>( replid >> 32 ) };
+   engine.seed( seq );
+}
+#endif
+
+// Binary state file: magic, version, engine name, and the words of the text state of the engine
+// (4 bytes per word if all of them fit, 8 otherwise; native byte order)
+static const char BinaryStateMagic[8] = { 'H', 'S', 'D', 'Y', 'R', 'N', 'G', '\0' };
+static const uint32_t BinaryStateVersion = 1;
+
+static void writeBinaryState( ostream& out, const RngEngineType& engine ) {
+   ostringstream text;
+   text << engine;
+   istringstream fields( text.str() );
+   vector<uint64_t> words;
+   uint64_t word;
+   while ( fields >> word ) { words.push_back( word ); }
+   uint32_t wordbytes = 4;
+   for ( uint64_t w : words ) { if ( w > 0xFFFFFFFF ) { wordbytes = 8; } }
+   string name = RNG_ENGINE_NAME;
+   uint32_t namelength = static_cast<uint32_t>( name.size() );
+   uint32_t nwords = static_cast<uint32_t>( words.size() );
+   out.write( BinaryStateMagic, sizeof(BinaryStateMagic) );
+   out.write( reinterpret_cast<const char*>( &BinaryStateVersion ), sizeof(BinaryStateVersion) );
+   out.write( reinterpret_cast<const char*>( &namelength ), sizeof(namelength) );
+   out.write( name.data(), namelength );
+   out.write( reinterpret_cast<const char*>( &nwords ), sizeof(nwords) );
+   out.write( reinterpret_cast<const char*>( &wordbytes ), sizeof(wordbytes) );
+   for ( uint64_t w : words ) {
+      if ( wordbytes == 4 ) {
+         uint32_t w32 = static_cast<uint32_t>( w );
+         out.write( reinterpret_cast<const char*>( &w32 ), sizeof(w32) );
+      }
+      else { out.write( reinterpret_cast<const char*>( &w ), sizeof(w) ); }
+   }
+}
+
+// Returns false if the stream does not start with the magic of a binary state (e.g. a text state)
+static bool readBinaryState( istream& in, RngEngineType& engine, const string& filename ) {
+   char magic[8];
+   if ( !in.read( magic, sizeof(magic) ) || !equal( magic, magic + 8, BinaryStateMagic ) ) { return false; }
+   uint32_t version = 0, namelength = 0, nwords = 0, wordbytes = 0;
+   in.read( reinterpret_cast<char*>( &version ), sizeof(version) );
+   in.read( reinterpret_cast<char*>( &namelength ), sizeof(namelength) );
+   string name( namelength, ' ' );
+   in.read( &name[0], namelength );
+   in.read( reinterpret_cast<char*>( &nwords ), sizeof(nwords) );
+   in.read( reinterpret_cast<char*>( &wordbytes ), sizeof(wordbytes) );
+   if ( !in || version != BinaryStateVersion || name != RNG_ENGINE_NAME || ( wordbytes != 4 && wordbytes != 8 ) ) {
+      cerr << "Error: RNG state file " << filename << " (version " << version << ", engine " << name
+         << ") cannot be read by this build (version " << BinaryStateVersion << ", engine " << RNG_ENGINE_NAME << ")" << endl;
+      exit(1);
+   }
+   ostringstream text;
+   for ( uint32_t i = 0; i < nwords; ++i ) {
+      uint64_t w = 0;
+      if ( wordbytes == 4 ) {
+         uint32_t w32 = 0;
+         in.read( reinterpret_cast<char*>( &w32 ), sizeof(w32) );
+         w = w32;
+      }
+      else { in.read( reinterpret_cast<char*>( &w ), sizeof(w) ); }
+      text << ( i > 0 ? " " : "" ) << w;
+   }
+   if ( !in ) {
+      cerr << "Error: RNG state file " << filename << " is truncated" << endl;
+      exit(1);
+   }
+   istringstream fields( text.str() );
+   fields >> engine;
+   return true;
+}
 
 // ---Static member functions---
 void Rng::Rng_init() {
-  std::string replid = std::to_string( Simul::getReplID() );
-  ifstream frand("RNG_internal_state/RNGis" + Simul::getScenID() + "_" + replid + ".dat");
+   if ( StreamMode ) { // the substreams depend only on the master seed and the replicate: no state file
+      // Key = splitmix64 finaliser of the seed combined with the replicate ID
+      Rng_stream.setKey( mix64( Seed + 0x9E3779B97F4A7C15 * ( static_cast<uint64_t>( Simul::getReplID() ) + 1 ) ) );
+      setStream( 0, PopEntity, StreamInit );
+      return;
+   }
+   if ( FromSeed ) { // the engine depends only on the master seed and the replicate: no state file
+      seedReplicate( Rng_engine, Seed, static_cast<uint64_t>( Simul::getReplID() ) );
+      return;
+   }
+  ifstream frand( getStateFileName(), ios::binary );
    if (frand.is_open())
     {
-      frand >> Rng_engine;
+      if ( !readBinaryState( frand, Rng_engine, getStateFileName() ) ) { // text state
+         frand.clear();
+         frand.seekg( 0 );
+         frand >> Rng_engine;
+      }
     }
    else
    {
@@ -37,62 +170,144 @@ void Rng::Rng_init() {
 }
 
 void Rng::Rng_save() {
-  std::string replid = std::to_string( Simul::getReplID() );
-   ofstream frand("RNG_internal_state/RNGis" + Simul::getScenID() + "_" + replid + ".dat");
-   if (frand.is_open())
-      frand << Rng_engine;
+   if ( StreamMode || FromSeed ) { return; } // nothing to save
+   ofstream frand( getStateFileName(), ios::binary );
+   if (frand.is_open()) {
+      if ( BinaryState ) { writeBinaryState( frand, Rng_engine ); }
+      else { frand << Rng_engine; }
+   }
    frand.close();
 }
 
+std::string Rng::getStateFileName() {
+  std::string replid = std::to_string( Simul::getReplID() );
+  // The states of mt19937 keep the original name, so that stored replicates can be replayed
+  std::string engine = ( getEngineName() == "mt19937" ) ? "" : "_" + getEngineName();
+  return ( "RNG_internal_state/RNGis" + Simul::getScenID() + "_" + replid + engine + ".dat" );
+}
+
+std::string Rng::getEngineName() {return RNG_ENGINE_NAME;}
+
+void Rng::setStreamMode( bool streammode ) { StreamMode = streammode; }
+bool Rng::getStreamMode() {return StreamMode;}
+
+void Rng::setSeed( uint64_t seed ) { Seed = seed; }
+uint64_t Rng::getSeed() {return Seed;}
+
+void Rng::setFromSeed( bool fromseed ) { FromSeed = fromseed; }
+bool Rng::getFromSeed() {return FromSeed;}
+
+void Rng::setStateFormat( const string& format ) {
+   if ( format == "text" ) { BinaryState = false; }
+   else if ( format == "binary" ) { BinaryState = true; }
+   else {
+      cerr << "Error: unknown RNG state format \"" << format << "\" (use text or binary)" << endl;
+      exit(1);
+   }
+}
+bool Rng::getBinaryState() {return BinaryState;}
+
+void Rng::setLegacy( bool legacy ) { Legacy = legacy; }
+bool Rng::getLegacy() {return Legacy;}
+
+void Rng::setStream( uint32_t step, uint32_t entity, StreamPhase phase ) {
+   CurrStep = step;
+   CurrPhase = phase;
+   Rng_stream.setStream( entity, step, static_cast<uint32_t>( phase ) );
+   if ( StreamMode ) { BitsPos = BitsBlockSize; } // the buffered bits belong to the previous substream
+}
+
+void Rng::setEntity( uint32_t entity ) {
+   Rng_stream.setStream( entity, CurrStep, static_cast<uint32_t>( CurrPhase ) );
+   if ( StreamMode ) { BitsPos = BitsBlockSize; } // the buffered bits belong to the previous substream
+}
+
 uint32_t Rng::random_uint32() {
    uniform_int_distribution<uint32_t> dist{0, 0xFFFFFFFF}; // 0xFFFFFFFF = UINT32_MAX
-   return dist(Rng_engine);
+   return dist(Rng_urbg);
+}
+
+void Rng::fillRandomBits( uint32_t* words, size_t n ) {
+   size_t i = 0;
+   while ( i < n && BitsPos < BitsBlockSize ) { words[i++] = BitsBuffer[ BitsPos++ ]; } // use the buffered bits first
+   if ( Engine::Wide ) {
+      for ( ; i + 1 < n; i += 2 ) {
+         uint64_t bits = Rng_urbg();
+         words[i] = static_cast<uint32_t>( bits );
+         words[i+1] = static_cast<uint32_t>( bits >> 32 );
+      }
+   }
+   for ( ; i < n; ++i ) { words[i] = static_cast<uint32_t>( Rng_urbg() ); }
 }
 
 uint64_t Rng::random_uint64() {
    uniform_int_distribution<uint64_t> dist{0, 0xFFFFFFFFFFFFFFFF}; // 0xFFFFFFFFFFFFFFFF = UINT64_MAX
-   return dist(Rng_engine);
+   return dist(Rng_urbg);
 }
 
 double Rng::unif_01() {
 uniform_real_distribution<double> dist{0,1};
-   return dist(Rng_engine);
+   return dist(Rng_urbg);
 }
 
 // ---Non-static member functions---
 double Rng::uniform_real(double min, double max) {
    uniform_real_distribution<double> dist{min, max};
-   return dist(Rng_engine);
+   return dist(Rng_urbg);
 }
 
 int Rng::uniform_int(int  min, int max) {
    uniform_int_distribution<int> dist{min, max};
-   return dist(Rng_engine);
+   return dist(Rng_urbg);
 }
 
 bool Rng::bernoulli(double prob) {
    bernoulli_distribution dist{prob};
-   return dist(Rng_engine);
+   return dist(Rng_urbg);
 }
 
 int Rng::binomial(int trials, double prob) {
+   if ( !Legacy ) { return ( getBinomialSampler( prob ).sample( trials ) ); }
    binomial_distribution<> dist{trials, prob};
-   return dist(Rng_engine);
+   return dist(Rng_urbg);
+}
+
+void Rng::binomial(const std::vector<int>& trials, double prob, std::vector<int>& results) {
+   if ( !Legacy ) {
+      getBinomialSampler( prob ).sample( trials, results );
+      return;
+   }
+   results.resize( trials.size() );
+   for ( size_t i = 0; i < trials.size(); ++i ) { results[i] = binomial( trials[i], prob ); }
 }
 
 int Rng::poisson(double mean) {
+   if ( !Legacy ) {
+      if ( mean <= 0 ) { return 0; }
+      return ( ( mean < PoissonPtrsMin ) ? poissonInversion( mean ) : poissonPtrs( mean ) );
+   }
    poisson_distribution<> dist{mean};
-   return dist(Rng_engine);
+   return dist(Rng_urbg);
+}
+
+void Rng::poisson(const std::vector<double>& means, std::vector<int>& results) {
+   results.resize( means.size() );
+   for ( size_t i = 0; i < means.size(); ++i ) { results[i] = poisson( means[i] ); } // equal consecutive means reuse the cached setup
 }
 
 double Rng::normal(double mean, double stdev) {
    normal_distribution<> dist{mean, stdev};
-   return dist(Rng_engine);
+   return dist(Rng_urbg);
 }
 
 int Rng::negative_binomial(double mean, double theta) {
    // Here we use an alternative parameterization based on mean and theta
    // E.g. see https://stat.ethz.ch/R-manual/R-devel/library/stats/html/NegBinomial.html
+   if ( !Legacy ) {
+      // Gamma-Poisson mixture: X ~ Poisson(lambda), lambda ~ Gamma(shape = theta, scale = mean / theta)
+      if ( mean <= 0 ) { return 0; }
+      return ( poisson( gamma( theta, mean / theta ) ) );
+   }
    double r = theta;
    double p = theta / ( theta + mean );
    // r and p are the standard parameters of a negative binomial
@@ -104,21 +319,200 @@ int Rng::negative_binomial(double mean, double theta) {
    return ( boost::math::quantile(dist, randnumber) );
 }
 
+int Rng::negative_binomial_zt(double mean, double theta) {
+   if ( mean <= 0 ) {
+      cerr << "Error: a zero-truncated negative binomial needs a positive mean (mean = " << mean << ")" << endl;
+      exit(1);
+   }
+   if ( Legacy ) { // sample until the value is not zero
+      int n = negative_binomial( mean, theta );
+      while ( n == 0 ) { n = negative_binomial( mean, theta ); }
+      return n;
+   }
+   // The mixture conditioned on X > 0 has lambda ~ Gamma(theta, mean / theta) weighted by P(X > 0 | lambda) = 1 - exp(-lambda),
+   // and X | lambda ~ zero-truncated Poisson(lambda): lambda is sampled by rejection, without sampling X for the rejected values
+   double lambda = gamma( theta, mean / theta );
+   while ( unif_01() >= -expm1( -lambda ) ) { lambda = gamma( theta, mean / theta ); }
+   return ( poisson_zt( lambda ) );
+}
+
+double Rng::gamma(double shape, double scale) {
+   // G. Marsaglia and W.W. Tsang (2000) A simple method for generating gamma variables.
+   // ACM Transactions on Mathematical Software 26:363-372
+   if ( shape < 1 ) { // Gamma(shape) = Gamma(shape + 1) * U^(1/shape)
+      double u = unif_01();
+      while ( u == 0 ) { u = unif_01(); }
+      return ( gamma( shape + 1, scale ) * pow( u, 1 / shape ) );
+   }
+   const double d = shape - 1.0 / 3;
+   const double c = 1 / sqrt( 9 * d );
+   while ( true ) {
+      double x, v;
+      do {
+         x = std_normal();
+         v = 1 + c * x;
+      } while ( v <= 0 );
+      v = v * v * v;
+      double u = unif_01();
+      if ( u < 1 - 0.0331 * x * x * x * x ) { return ( d * v * scale ); } // squeeze
+      if ( log( u ) < 0.5 * x * x + d * ( 1 - v + log( v ) ) ) { return ( d * v * scale ); }
+   }
+}
+
 // To get a random 64-bit integer with k 1-bits:
-uint64_t Rng::random_k_bits(int k) {
-  return k_bit_helper(64, k, 1, 0);
+uint64_t Rng::random_k_bits(int k, int n) {
+  if ( Legacy ) {
+     return k_bit_helper(n, k, 1, 0); // one uniform draw per bit
+  }
+  uint64_t word = 0;
+  random_k_bits( k, n, &word );
+  return word;
+}
+
+// To get a random bit array of n bits with k 1-bits:
+void Rng::random_k_bits(int k, int n, uint64_t* words) {
+   const int nwords = ( n + 63 ) / 64;
+   for ( int i = 0; i < nwords; ++i ) { words[i] = 0; }
+   k = ( k < 0 ) ? 0 : ( ( k > n ) ? n : k );
+   if ( k + k <= n ) {
+      floyd_k_bits( k, n, words );
+   }
+   else { // sample the n - k 0-bits and take the complement (at most n/2 draws)
+      floyd_k_bits( n - k, n, words );
+      for ( int i = 0; i < nwords; ++i ) { words[i] = ~words[i]; }
+      if ( n % 64 != 0 ) { words[nwords-1] &= ( static_cast<uint64_t>( 1 ) << ( n % 64 ) ) - 1; }
+   }
 }
 
 // To get a vector with randomized indexes from 0 to n-1:
 std::vector<int> Rng::randIndexVect( int n ) {
    std::vector<int> vecRandPop(n);
    std::iota (std::begin(vecRandPop), std::end(vecRandPop), 0);
-   std::shuffle( begin(vecRandPop), end(vecRandPop), Rng_engine );
+   std::shuffle( begin(vecRandPop), end(vecRandPop), Rng_urbg );
    return( vecRandPop );
 }
 
    // Utility functions
 
+int Rng::poissonInversion(double mean) {
+   // Direct-mapped cache: the table of a mean is kept until another mean maps to the same slot
+   uint64_t bits;
+   memcpy( &bits, &mean, sizeof(bits) );
+   PoissonTable& table = PoissonTables[ ( bits ^ ( bits >> 20 ) ^ ( bits >> 40 ) ) % PoissonNTables ];
+   if ( table.Mean != mean ) {
+      table.Mean = mean;
+      table.Prob = exp( -mean );
+      table.Cdf[0] = table.Prob;
+      table.Size = 1;
+   }
+   double u = unif_01();
+   int k = 0;
+   while ( u > table.Cdf[k] ) {
+      ++k;
+      if ( k == table.Size ) { // extend the table up to k
+         if ( k == PoissonTableSize ) { return ( k - 1 ); } // P(X >= 64) < 1e-30 for means below 10
+         table.Prob *= mean / k;
+         table.Cdf[k] = table.Cdf[k-1] + table.Prob;
+         ++table.Size;
+      }
+   }
+   return k;
+}
+
+BinomialSampler& Rng::getBinomialSampler(double prob) {
+   // Direct-mapped cache: the setup of a probability is kept until another probability maps to the same slot
+   uint64_t bits;
+   memcpy( &bits, &prob, sizeof(bits) );
+   BinomialSampler& sampler = BinomialSamplers[ ( bits ^ ( bits >> 20 ) ^ ( bits >> 40 ) ) % BinomialNSamplers ];
+   if ( sampler.getProb() != prob ) { sampler.setProb( prob ); }
+   return sampler;
+}
+
+int Rng::poissonPtrs(double mean) {
+   // W. Hörmann (1993) The transformed rejection method for generating Poisson random variables.
+   // Insurance: Mathematics and Economics 12:39-45
+   PoissonPtrs& c = PoissonPtrsCache;
+   if ( c.Mean != mean ) {
+      c.Mean = mean;
+      c.SqrtMean = sqrt( mean );
+      c.LogMean = log( mean );
+      c.b = 0.931 + 2.53 * c.SqrtMean;
+      c.a = -0.059 + 0.02483 * c.b;
+      c.LogInvAlpha = log( 1.1239 + 1.1328 / ( c.b - 3.4 ) );
+      c.Vr = 0.9277 - 3.6224 / ( c.b - 2 );
+   }
+   while ( true ) {
+      double u = unif_01() - 0.5;
+      double v = unif_01();
+      double us = 0.5 - fabs( u );
+      long k = static_cast<long>( floor( ( 2 * c.a / us + c.b ) * u + mean + 0.43 ) );
+      if ( ( us >= 0.07 ) && ( v <= c.Vr ) ) { return static_cast<int>( k ); } // squeeze
+      if ( ( k < 0 ) || ( ( us < 0.013 ) && ( v > us ) ) ) { continue; }
+      if ( ( log( v ) + c.LogInvAlpha - log( c.a / ( us * us ) + c.b ) ) <= ( -mean + k * c.LogMean - lgamma( k + 1.0 ) ) ) {
+         return static_cast<int>( k );
+      }
+   }
+}
+
+int Rng::poisson_zt(double mean) {
+   if ( mean >= PoissonPtrsMin ) { // P(X = 0) < 5e-5: sample until the value is not zero
+      int n = poissonPtrs( mean );
+      while ( n == 0 ) { n = poissonPtrs( mean ); }
+      return n;
+   }
+   // Sequential inversion from 1: P(X = k | X > 0) = exp(-mean) mean^k / k! / (1 - exp(-mean))
+   double prob = mean / expm1( mean ); // P(X = 1 | X > 0)
+   double cdf = prob;
+   double u = unif_01();
+   int k = 1;
+   while ( ( u > cdf ) && ( k < PoissonTableSize ) ) {
+      ++k;
+      prob *= mean / k;
+      cdf += prob;
+   }
+   return k;
+}
+
+double Rng::std_normal() {
+   // The second deviate of each pair is not kept, so that the result does not depend on previous calls
+   double u, v, s;
+   do {
+      u = 2 * unif_01() - 1;
+      v = 2 * unif_01() - 1;
+      s = u * u + v * v;
+   } while ( ( s >= 1 ) || ( s == 0 ) );
+   return ( u * sqrt( -2 * log( s ) / s ) );
+}
+
+uint32_t Rng::uniform_below(uint32_t range) {
+   // D. Lemire (2019) Fast random integer generation in an interval. ACM Trans. Model. Comput. Simul. 29:3
+   uint64_t m = static_cast<uint64_t>( static_cast<uint32_t>( Rng_urbg() ) ) * range;
+   uint32_t low = static_cast<uint32_t>( m );
+   if ( low < range ) {
+      uint32_t threshold = ( 0 - range ) % range;
+      while ( low < threshold ) {
+         m = static_cast<uint64_t>( static_cast<uint32_t>( Rng_urbg() ) ) * range;
+         low = static_cast<uint32_t>( m );
+      }
+   }
+   return static_cast<uint32_t>( m >> 32 );
+}
+
+void Rng::floyd_k_bits(int k, int n, uint64_t* words) {
+   // R.W. Floyd's algorithm (Bentley and Floyd 1987, Programming pearls: a sample of brilliance. Commun. ACM 30:754-757):
+   // one uniform draw per 1-bit, and every set of k bits among n is equally likely
+   for ( int j = n - k; j < n; ++j ) {
+      int t = static_cast<int>( uniform_below( static_cast<uint32_t>( j ) + 1 ) );
+      if ( ( words[ t >> 6 ] >> ( t & 63 ) ) & 1 ) { t = j; } // bit t already chosen: choose bit j instead
+      words[ t >> 6 ] |= static_cast<uint64_t>( 1 ) << ( t & 63 );
+   }
+}
+
+void Rng::refillBits() {
+   fillRandomBits( BitsBuffer, BitsBlockSize ); // the buffer is empty, so this fills it from the engine
+   BitsPos = 0;
+}
+
 uint64_t Rng::k_bit_helper(int n, int k, uint64_t bit, uint64_t accum) {
   if (!(n && static_cast<uint64_t>(k)))
     return accum;
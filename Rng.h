@@ -6,41 +6,142 @@
 #include <random>
 #include <cstdint> // uint32_t and uint64_t types
 #include <string>
+#include <vector>
+#include <type_traits>
+#include "Philox.h"
+#include "BinomialSampler.h"
+#include "RngEngines.h" // RngEngineType (mt19937, xoshiro256** or PCG64, chosen at compile time)
 
 class Rng {
 public:
    // Default constructor
    // Rng();
 
+   // Phases of the simulation that draw from their own substreams (stream mode)
+   enum StreamPhase {
+      StreamInit = 0, // first immigration from source
+      StreamHorizTrans, // horizontal transmission
+      StreamSReproduction, // symbiont reproduction
+      StreamHReproduction, // host reproduction
+      StreamHMortality, // host mortality
+      StreamHImmigration // host immigration
+   };
+
+   static const uint32_t PopEntity = 0xFFFFFFFF; // Entity of the draws that are not specific to one host
+
+   // Uniform random bit generator used by all the distributions:
+   // the current Philox4x32 substream in stream mode, the engine RngEngineType otherwise.
+   // Its width is that of RngEngineType (32 bits for mt19937, 64 bits for xoshiro256** and PCG64)
+   struct Engine {
+      static constexpr bool Wide = ( RngEngineType::max() > 0xFFFFFFFF );
+      typedef typename std::conditional<Wide, uint64_t, uint32_t>::type result_type;
+      static constexpr result_type min() { return 0; }
+      static constexpr result_type max() { return Wide ? static_cast<result_type>( 0xFFFFFFFFFFFFFFFF ) : 0xFFFFFFFF; }
+      result_type operator()() {
+         if ( StreamMode ) { return Wide ? static_cast<result_type>( static_cast<uint64_t>( Rng_stream() ) << 32 | Rng_stream() ) : Rng_stream(); }
+         return static_cast<result_type>( Rng_engine() );
+      }
+   };
+
+   static void setStreamMode( bool ); // Set StreamMode
+   static bool getStreamMode(); // Get StreamMode
+   static void setSeed( uint64_t ); // Set Seed
+   static uint64_t getSeed(); // Get Seed
+   static void setFromSeed( bool ); // Set FromSeed
+   static bool getFromSeed(); // Get FromSeed
+   static void setStateFormat( const std::string& ); // Set BinaryState from the name of the format of saved states (text or binary)
+   static bool getBinaryState(); // Get BinaryState
+   static void setLegacy( bool ); // Set Legacy
+   static bool getLegacy(); // Get Legacy
+
+   // Select the substream of a (step, host ID index, phase) of the current replicate (stream mode only)
+   static void setStream( uint32_t, uint32_t, StreamPhase ); // Parameters: step, entity (host ID index or PopEntity) and phase
+   static void setEntity( uint32_t ); // Change only the entity of the current substream
 
    static void Rng_init(); // use thread_local here in a multithreading context
    static void Rng_save(); // use thread_local here in a multithreading context
+   static std::string getStateFileName(); // Get the path of the file storing the engine state of the current scenario and replicate
+   static std::string getEngineName(); // Get the name of the engine chosen at compile time
    static uint32_t random_uint32();
+   // Random bits from a buffer refilled in blocks (no distribution per call); see also fillRandomBits
+   static uint32_t random_bits32() {
+      if ( BitsPos == BitsBlockSize ) { refillBits(); }
+      return BitsBuffer[ BitsPos++ ];
+   }
+   static void fillRandomBits( uint32_t*, size_t ); // Fill an array with random 32-bit words
    static uint64_t random_uint64();
    static double unif_01();
 
 // We don't use thread_local in a distribution if we plan to use different parameter values among calls
    double uniform_real(double,double); // Parameters: min and max
    int uniform_int(int,int); // Parameters: min and max
+   static uint32_t uniform_below(uint32_t); // Uniform integer in [0, range) without constructing a distribution (range > 0)
    bool bernoulli(double); // Parameters: probability of success
    int binomial(int,double); // Parameters: number of trials and probability of success
+   void binomial(const std::vector<int>&, double, std::vector<int>&); // Parameters: numbers of trials, probability of success, and vector of results (one per number of trials)
    int poisson(double); // Parameters: mean
+   void poisson(const std::vector<double>&, std::vector<int>&); // Parameters: means, and vector of results (one per mean)
    double normal(double,double); // Parameters: mean and standard deviation
    int negative_binomial(double,double); // Parameters: mean and dispersion parameter*
+   int negative_binomial_zt(double,double); // Zero-truncated negative binomial (only values > 0). Parameters: mean and dispersion parameter* of the untruncated distribution
       // *Alternative parameterization
       // see https://en.wikipedia.org/wiki/Negative_binomial_distribution
+   double gamma(double,double); // Parameters: shape and scale
 
-// To get a random 64-bit integer with k 1-bits:
-   uint64_t random_k_bits(int);
+// To get a random integer of n bits (n <= 64) with k 1-bits (k is clamped to [0,n]):
+   uint64_t random_k_bits(int, int = 64); // Parameters: k and n
+// To get a random bit array of n bits (words[i] holds bits 64i to 64i+63) with k 1-bits:
+   void random_k_bits(int, int, uint64_t*); // Parameters: k, n and pointer to the ceil(n/64) words
 
 // To get a vector with randomized indexes from 0 to n-1:
    std::vector<int> randIndexVect( int );
 
 private:
-   static std::mt19937 Rng_engine; // Random Number Algorithm; use thread_local here in a multithreading context
+   static RngEngineType Rng_engine; // Random Number Algorithm; use thread_local here in a multithreading context
+   static Philox4x32 Rng_stream; // Counter-based engine of the current substream (stream mode); use thread_local here in a multithreading context
+   static Engine Rng_urbg; // Generator passed to the distributions
+   static bool StreamMode; // Whether draws come from counter-based substreams instead of mt19937
+   static uint64_t Seed; // Master seed of the substreams (stream mode) or of the replicate engines (FromSeed)
+   static uint32_t CurrStep; // Step of the current substream
+   static StreamPhase CurrPhase; // Phase of the current substream
+   static bool FromSeed; // Whether the engine is derived from the master seed and the replicate ID instead of a state file
+   static bool BinaryState; // Whether Rng_save writes the binary state format (Rng_init reads both formats)
+   static bool Legacy; // Whether the standard library (and Boost) distributions are used, as in the stored replicates
+
+   // Poisson sampler (used when Legacy is false)
+   static const int PoissonTableSize = 64; // Maximum number of cumulative probabilities cached per mean
+   static const int PoissonNTables = 16; // Number of cached means (direct-mapped by the bits of the mean)
+   static constexpr double PoissonPtrsMin = 10; // Means from which the PTRS rejection method is used
+   struct PoissonTable { // Cumulative distribution function of one mean, extended as needed
+      double Mean; // mean (-1 if the table is empty)
+      int Size; // number of cached cumulative probabilities
+      double Prob; // probability of Size-1
+      double Cdf[PoissonTableSize]; // Cdf[k] = P(X <= k)
+   };
+   struct PoissonPtrs { // Constants of the PTRS method for one mean
+      double Mean, SqrtMean, LogMean, a, b, LogInvAlpha, Vr;
+   };
+   static PoissonTable PoissonTables[PoissonNTables];
+   static PoissonPtrs PoissonPtrsCache;
+
+   // Buffer of random bits
+   static const int BitsBlockSize = 256; // Number of 32-bit words generated per refill
+   static uint32_t BitsBuffer[BitsBlockSize]; // use thread_local here in a multithreading context
+   static int BitsPos; // Next word of BitsBuffer (BitsBlockSize if the buffer is empty)
+   static void refillBits(); // Refill BitsBuffer from the engine (or the current substream)
+
+   // Binomial samplers (used when Legacy is false)
+   static const int BinomialNSamplers = 8; // Number of cached probabilities (direct-mapped by the bits of the probability)
+   static BinomialSampler BinomialSamplers[BinomialNSamplers];
+   static BinomialSampler& getBinomialSampler( double ); // Get the sampler of a probability
 
    // Utility functions
    uint64_t k_bit_helper(int, int, uint64_t, uint64_t);
+   void floyd_k_bits(int, int, uint64_t*); // Floyd's sampling of k distinct bits among n (k <= n)
+   int poissonInversion(double); // Inversion with a cached cumulative distribution function (small means)
+   int poissonPtrs(double); // Transformed rejection with squeeze (Hörmann 1993) (large means)
+   int poisson_zt(double); // Zero-truncated Poisson (only values > 0). Parameters: mean of the untruncated distribution
+   double std_normal(); // Standard normal deviate (Marsaglia polar method)
 
    };
 
@@ -0,0 +1,180 @@
+// Random number engines that can replace std::mt19937 in the Rng class
+// Member functions are defined within the class definition's body so that they can be inlined
+
+/* The engine of the Rng class is chosen at compile time:
+      (default)           std::mt19937 (legacy; replays all the stored RNG states)
+      -DRNG_XOSHIRO256    xoshiro256** 1.0 (Blackman and Vigna 2018): 256-bit state, 64-bit output
+      -DRNG_PCG64         PCG64, i.e. PCG XSL RR 128/64 (O'Neill 2014): 128-bit state, 64-bit output
+                          (needs a compiler with unsigned __int128, e.g. GCC or Clang)
+   Both engines satisfy the requirements of a random number engine as far as Rng uses them
+   (result_type, min, max, operator(), seeding from a std::seed_seq, and text input/output of the
+   state with >> and <<), so that Rng_init and Rng_save work with any of them.
+*/
+
+#ifndef RNGENGINES_H
+#define RNGENGINES_H
+
+#include <cstdint> // uint32_t and uint64_t types
+#include <random>
+#include <iostream>
+
+/**** xoshiro256** ****/
+class Xoshiro256ss {
+public:
+   typedef uint64_t result_type;
+
+   static constexpr result_type min() { return 0; }
+   static constexpr result_type max() { return 0xFFFFFFFFFFFFFFFF; }
+
+   Xoshiro256ss() : S{ 0x9E3779B97F4A7C15, 0xBF58476D1CE4E5B9, 0x94D049BB133111EB, 0x2545F4914F6CDD1D } {} // constructor
+
+   // Seed the state from a seed sequence (the state must not be all zero)
+   template<class Sseq>
+   void seed( Sseq& seq ) {
+      uint32_t words[8];
+      seq.generate( words, words + 8 );
+      for ( int i = 0; i < 4; ++i ) { S[i] = static_cast<uint64_t>( words[2*i] ) << 32 | words[2*i+1]; }
+      if ( ( S[0] | S[1] | S[2] | S[3] ) == 0 ) { S[0] = 1; }
+   }
+
+   // Seed the state from a 64-bit seed with splitmix64, as recommended by the authors of xoshiro
+   void seed( uint64_t seed ) {
+      for ( int i = 0; i < 4; ++i ) {
+         uint64_t z = ( seed += 0x9E3779B97F4A7C15 );
+         z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9;
+         z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EB;
+         S[i] = z ^ ( z >> 31 );
+      }
+   }
+
+   // Advance the state by 2^128 steps (jump polynomial of the reference implementation),
+   // which splits the sequence into 2^128 non-overlapping substreams
+   void jump() {
+      static const uint64_t JUMP[4] = { 0x180EC6D33CFD0ABA, 0xD5A61266F0C9392C, 0xA9582618E03FC9AA, 0x39ABDC4529B1661C };
+      uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+      for ( int i = 0; i < 4; ++i ) {
+         for ( int b = 0; b < 64; ++b ) {
+            if ( JUMP[i] & ( static_cast<uint64_t>( 1 ) << b ) ) {
+               s0 ^= S[0];
+               s1 ^= S[1];
+               s2 ^= S[2];
+               s3 ^= S[3];
+            }
+            ( *this )();
+         }
+      }
+      S[0] = s0;
+      S[1] = s1;
+      S[2] = s2;
+      S[3] = s3;
+   }
+
+   result_type operator()() {
+      const uint64_t result = rotl( S[1] * 5, 7 ) * 9;
+      const uint64_t t = S[1] << 17;
+      S[2] ^= S[0];
+      S[3] ^= S[1];
+      S[1] ^= S[2];
+      S[0] ^= S[3];
+      S[2] ^= t;
+      S[3] = rotl( S[3], 45 );
+      return result;
+   }
+
+   friend std::ostream& operator<<( std::ostream& out, const Xoshiro256ss& engine ) {
+      return out << engine.S[0] << " " << engine.S[1] << " " << engine.S[2] << " " << engine.S[3];
+   }
+
+   friend std::istream& operator>>( std::istream& in, Xoshiro256ss& engine ) {
+      return in >> engine.S[0] >> engine.S[1] >> engine.S[2] >> engine.S[3];
+   }
+
+private:
+   uint64_t S[4]; // 256-bit state
+
+   static uint64_t rotl( uint64_t x, int k ) { return ( x << k ) | ( x >> ( 64 - k ) ); }
+   };
+
+/**** PCG64 (PCG XSL RR 128/64) ****/
+#if defined(__SIZEOF_INT128__)
+class Pcg64 {
+public:
+   typedef uint64_t result_type;
+   typedef unsigned __int128 uint128;
+
+   static constexpr result_type min() { return 0; }
+   static constexpr result_type max() { return 0xFFFFFFFFFFFFFFFF; }
+
+   Pcg64() { seed( 0xCAFEF00DD15EA5E5, 0xA02BDBF7BB3C0A7 ); } // constructor
+
+   // Seed the state and the stream (the increment) as pcg64_srandom_r does
+   void seed( uint128 initstate, uint128 initseq ) {
+      State = 0;
+      Inc = ( initseq << 1 ) | 1;
+      step();
+      State += initstate;
+      step();
+   }
+
+   // Seed the state and the stream from a seed sequence
+   template<class Sseq>
+   void seed( Sseq& seq ) {
+      uint32_t words[8];
+      seq.generate( words, words + 8 );
+      uint128 initstate = 0;
+      uint128 initseq = 0;
+      for ( int i = 0; i < 4; ++i ) {
+         initstate = ( initstate << 32 ) | words[i];
+         initseq = ( initseq << 32 ) | words[i+4];
+      }
+      seed( initstate, initseq );
+   }
+
+   result_type operator()() {
+      step();
+      const uint64_t xsl = static_cast<uint64_t>( State >> 64 ) ^ static_cast<uint64_t>( State );
+      const int rot = static_cast<int>( State >> 122 );
+      return ( xsl >> rot ) | ( xsl << ( ( -rot ) & 63 ) );
+   }
+
+   friend std::ostream& operator<<( std::ostream& out, const Pcg64& engine ) {
+      return out << static_cast<uint64_t>( engine.State >> 64 ) << " " << static_cast<uint64_t>( engine.State ) << " "
+         << static_cast<uint64_t>( engine.Inc >> 64 ) << " " << static_cast<uint64_t>( engine.Inc );
+   }
+
+   friend std::istream& operator>>( std::istream& in, Pcg64& engine ) {
+      uint64_t words[4];
+      if ( in >> words[0] >> words[1] >> words[2] >> words[3] ) {
+         engine.State = static_cast<uint128>( words[0] ) << 64 | words[1];
+         engine.Inc = static_cast<uint128>( words[2] ) << 64 | words[3];
+      }
+      return in;
+   }
+
+private:
+   uint128 State; // 128-bit state
+   uint128 Inc; // 128-bit increment (odd), which selects the stream
+
+   void step() {
+      const uint128 mult = static_cast<uint128>( 0x2360ED051FC65DA4 ) << 64 | 0x4385DF649FCCF645;
+      State = State * mult + Inc;
+   }
+   };
+#endif // __SIZEOF_INT128__
+
+/**** Engine selected at compile time ****/
+#if defined(RNG_XOSHIRO256)
+typedef Xoshiro256ss RngEngineType;
+#define RNG_ENGINE_NAME "xoshiro256ss"
+#elif defined(RNG_PCG64)
+#if !defined(__SIZEOF_INT128__)
+#error "RNG_PCG64 needs a compiler with unsigned __int128"
+#endif
+typedef Pcg64 RngEngineType;
+#define RNG_ENGINE_NAME "pcg64"
+#else
+typedef std::mt19937 RngEngineType;
+#define RNG_ENGINE_NAME "mt19937"
+#endif
+
+#endif // RNGENGINES_H
@@ -3,6 +3,7 @@
 #include <string>
 #include <iomanip>
 #include <stdexcept>
+#include <cstdlib> // exit() function
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -17,11 +18,18 @@
 #include "Simul.h"
 #include "Population.h"
 #include "Metapopulation.h"
+#include "Profiler.h"
+#include "Golden.h"
 
 #include <cstdint> // uint32_t and uint64_t types
 #include <string>
+#include <chrono>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h> // getrusage() function
+#endif
 
 using namespace std;
+using namespace std::chrono;
 
 // ---Static member functions---
 
@@ -35,7 +43,7 @@ void Simul::runSimul() {
   // Create a rng object
    Rng rng;
    rng.Rng_init();
-   rng.Rng_save(); // place after Rng_init to save the initial state
+   rng.Rng_save(); // place after Rng_init to save the initial state (nothing to save in stream mode)
   // Create the continent and the island:
    SourcePatch continent;
    Patch island;
@@ -50,21 +58,55 @@ void Simul::runSimul() {
   // Create output files and print headers into the files:
    Output::createOutputFiles();
    Output::printHeadersToFiles();
+  // Prepare the golden-output regression harness (only if enabled)
+   Golden::init();
  // Run cycles
    int Ncycles = NYears*NHReprPerYear*NStepsPerHRepr;
+   Profiler::init();
+   auto loopStart = steady_clock::now();
    for (int counter = 0; counter < Ncycles; ++counter) {
       Output::setCurrSimStep( counter );
+      Rng::setStream( counter, Rng::PopEntity, Rng::StreamHorizTrans );
+      Profiler::start( Profiler::PhaseHorizTrans );
       smpop.horizTrans( rng, hpop );
+      Profiler::stop( Profiler::PhaseHorizTrans );
+      Rng::setStream( counter, Rng::PopEntity, Rng::StreamSReproduction ); // one substream per host (see metapopReproduction)
+      Profiler::start( Profiler::PhaseSReproduction );
       smpop.metapopReproduction( hpop, rng );
+      Profiler::stop( Profiler::PhaseSReproduction );
       if (counter % NStepsPerHRepr == ( NStepsPerHRepr - 1 )) { // First host reproductive cycle at step 11
+         Rng::setStream( counter, Rng::PopEntity, Rng::StreamHReproduction );
+         Profiler::start( Profiler::PhaseHReproduction );
          hpop.popReproduction(island, rng, smpop);
+         Profiler::stop( Profiler::PhaseHReproduction );
+         Rng::setStream( counter, Rng::PopEntity, Rng::StreamHMortality );
+         Profiler::start( Profiler::PhaseHMortality );
          hpop.popMortality(rng,smpop);
-         if ( counter < Ncycles-1200 ) { hpop.immigrFromSource( continent, rng, smpop ); } // last 100 years without host migration
+         Profiler::stop( Profiler::PhaseHMortality );
+         if ( counter < Ncycles-1200 ) { // last 100 years without host migration
+            Rng::setStream( counter, Rng::PopEntity, Rng::StreamHImmigration );
+            Profiler::start( Profiler::PhaseHImmigration );
+            hpop.immigrFromSource( continent, rng, smpop );
+            Profiler::stop( Profiler::PhaseHImmigration );
+         }
       }
 //      if ( counter >= Ncycles-2400 ) { // output only for the last 200 years without host migration
-         if ( counter % NStepsPerHRepr == NStepsPerHRepr - 1 ) { Output::printDataToFiles( hpop, smpop ); } // Output frequency = 1 year (starting from the end of step 0)
+         if ( counter % NStepsPerHRepr == NStepsPerHRepr - 1 ) { // Output frequency = 1 year (starting from the end of step 0)
+            Profiler::start( Profiler::PhaseOutput );
+            Output::printDataToFiles( hpop, smpop );
+            Profiler::stop( Profiler::PhaseOutput );
+            Profiler::printYear( counter / ( NStepsPerHRepr * NHReprPerYear ) + 1 );
+         }
 //      }
    }
+  // Write the per-phase profile (only if the profiler is enabled)
+   Profiler::printProfile();
+  // Report the result of the golden-output verification (only if enabled)
+   if ( !Golden::finish() ) { exit(1); }
+  // Report throughput and peak memory (only in benchmark mode)
+   if ( BenchMode ) {
+      printBenchReport( duration<double>( steady_clock::now() - loopStart ).count(), hpop, smpop );
+   }
 }
 
 void Simul::setNStepsPerHRepr( int nsphr ) { NStepsPerHRepr = nsphr; }
@@ -82,12 +124,77 @@ string Simul::getScenID() {return ScenID;}
 void Simul::setReplID( int replid ) { ReplID = replid ; }
 int Simul::getReplID() {return ReplID;}
 
+void Simul::setBenchMode( bool benchmode ) { BenchMode = benchmode ; }
+bool Simul::getBenchMode() {return BenchMode;}
+
+long Simul::getPeakRSS() {
+#if defined(__unix__) || defined(__APPLE__)
+   struct rusage usage;
+   if ( getrusage( RUSAGE_SELF, &usage ) != 0 ) { return 0; }
+#if defined(__APPLE__)
+   return ( usage.ru_maxrss / 1024 ); // bytes in macOS
+#else
+   return ( usage.ru_maxrss ); // kilobytes in Linux
+#endif
+#else
+   return 0; // not available
+#endif
+}
+
+// ---Utility functions---
+
+void Simul::printBenchReport( double seconds, const Population<Host>& hpop, const Metapopulation<Population<Symbiont>>& smpop ) {
+   double ncycles = static_cast<double>( NYears ) * NHReprPerYear * NStepsPerHRepr;
+   double nhgens = static_cast<double>( NYears ) * NHReprPerYear;
+   long nsymb = 0;
+   for ( int counter = 0; counter < smpop.getN(); ++counter ) { nsymb += smpop.getMetapop()[counter].getN(); }
+   long peakrss = getPeakRSS();
+   std::string replid = std::to_string( ReplID );
+   ofstream fbench("output_full/bench" + ScenID + "_" + replid + ".csv");
+   if( !fbench ) { // file couldn't be opened
+      cerr << "Error: benchmark report file could not be opened" << endl;
+   }
+   else {
+      fbench << "Scenario ID" << ","
+         << "Replicate ID" << ","
+         << "Khost" << ","
+         << "Ksymbiont" << ","
+         << "HPopVecSize" << ","
+         << "SPopVecSize" << ","
+         << "NYears" << ","
+         << "Seconds" << ","
+         << "SCyclesPerSecond" << ","
+         << "HGenerationsPerSecond" << ","
+         << "PeakRSSKB" << ","
+         << "FinalNhost" << ","
+         << "FinalNsymbiont" << "\n";
+      fbench << ScenID << ","
+         << ReplID << ","
+         << Param::getKhost() << ","
+         << Param::getKsymbiont() << ","
+         << Param::getHPopVecSize() << ","
+         << Param::getSPopVecSize() << ","
+         << NYears << ","
+         << seconds << ","
+         << ncycles / seconds << ","
+         << nhgens / seconds << ","
+         << peakrss << ","
+         << hpop.getN() << ","
+         << nsymb << "\n";
+   }
+   cout << "Benchmark " << ScenID << "_" << replid << ": "
+      << ncycles / seconds << " symbiont cycles/s, "
+      << nhgens / seconds << " host generations/s, "
+      << "peak RSS " << peakrss << " KB" << endl;
+}
+
 // ---Static data members---
 int Simul::NStepsPerHRepr = Param::getNStepsPerHRepr();
 int Simul::NHReprPerYear = Param::getNHReprPerYear();
 int Simul::NYears = Param::getNYears();
 string Simul::ScenID = Param::getScenID();
 int Simul::ReplID = Param::getReplID();
+bool Simul::BenchMode = Param::getBenchMode();
 
 // constructor
 
@@ -6,6 +6,14 @@
 #include <cstdint> // uint32_t and uint64_t types
 #include <string>
 
+// Forward declarations:
+class Host;
+class Symbiont;
+template<typename T>
+class Population;
+template<typename T>
+class Metapopulation;
+
 class Simul {
 public:
    explicit Simul();
@@ -29,6 +37,11 @@ public:
    static void setReplID( int ); // Set NYears
    static int getReplID(); // Get NYears
 
+   static void setBenchMode( bool ); // Set BenchMode
+   static bool getBenchMode(); // Get BenchMode
+
+   static long getPeakRSS(); // Get the peak resident memory of the process (in kilobytes)
+
 private:
    
    static int NStepsPerHRepr; // Number of symbiont cycles (i.e. steps) per host reproductive event
@@ -36,6 +49,10 @@ private:
    static int NYears; // Number of years simulated
    static std::string ScenID; // ID of the simulation scenario
    static int ReplID; // ID of the simulation replicate
+   static bool BenchMode; // Whether throughput and peak memory are reported at the end of the run
+
+   // Utility functions
+   static void printBenchReport( double, const Population<Host>&, const Metapopulation<Population<Symbiont>>& ); // Print throughput and peak memory of the run
    };
 
 #endif // SIMUL_H
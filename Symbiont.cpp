@@ -38,48 +38,23 @@ double Symbiont::Evt = Param::getEvt();
 double Symbiont::mutRate = Param::getmutRateS();
 
 // constructor
-Symbiont::Symbiont(char sx, uint64_t gn, double ph)
+Symbiont::Symbiont(char sx, const ModelGenome::Gen& gn, double ph)
    : Organism (sx, gn, ph) {}
 
 void Symbiont::printIndividual() const {
    cout << Organism::toString() << "\n" << endl;
 }
 
-vector<Gamete> Symbiont::produceGametes(int64_t hostid, const Population<Host>& hpop, Rng& rng)  const {
-   int Ngametes = calculateNGametes(hostid, hpop, rng);
-//cout << "\nNgametes = " << Ngametes << "\n";
-   vector<Gamete> vgametes;
-   vgametes.reserve(Ngametes);
-   for (int i = 0; i < Ngametes; ++i) {
-      vgametes.push_back( createOneGamete() );
-   }
-   return(vgametes);
-}
-
-// ---Utility functions---
-
-Gamete Symbiont::createOneGamete() const {
-   Gamete gamete;
-   int32_t hplgen = createOneHaplGen();
-   gamete.setHaplGen( hplgen );
-   return(gamete);
-}
-
-int Symbiont::calculateNGametes(int64_t hostid, const Population<Host>& hpop, Rng& rng) const {
-   // Getting data from Host
-   const Host* ptrHost = hpop.getConstInd( hostid ); // hpop is the name of the host population
-   double N = static_cast<double>(ptrHost->getNsymbiont());
+double Symbiont::meanNGametes( double phen, double N, double HostPhen ) {
    double K = static_cast<double>( Host::getKsymbiont() );
-   double HostPhen = ptrHost->getPhen();
-   ptrHost = nullptr;
    // Calculation of the expected mean number of gamete produced
       double term1 = Rmax * ( 1 - N / K );
-      double term2 = ( getPhen() - HostPhen ) * ( getPhen() - HostPhen );
+      double term2 = ( phen - HostPhen ) * ( phen - HostPhen );
       double term3 = Vs + Vs;
       double R = term1 - term2 / term3;
-      // Sampling number of gametes
+      // Expected number of gametes
       double mean = exp(R) + exp(R);
-   return ( rng.poisson(mean) ); // rng.poisson(mean)
+   return ( mean );
 }
 
 
@@ -19,13 +19,12 @@ class Symbiont : public Organism {
 
 public:
 
-   explicit Symbiont (char = '\0', uint64_t = 0, double = 0.0); // constructor
+   explicit Symbiont (char = '\0', const ModelGenome::Gen& = ModelGenome::Gen(), double = 0.0); // constructor
 
    void printIndividual() const; // Print data members of the symbiont individual (function with extended functionality)
 
-   std::vector<Gamete> produceGametes(int64_t, const Population<Host>&, Rng& ) const; // Generate a vector of gametes produced by the symbiont in the current reproductive event
-
    // Static member functions (they cannot be declared as constant!)
+   static double meanNGametes( double, double, double ); // Expected number of gametes of a symbiont. Parameters: its phenotype, and the number of symbionts and phenotype of its host
    static double getRmax(); // Get Rmax
    static void setRmax( double ); // Set Rmax
    static double getVs(); // Get Vs
@@ -47,8 +46,6 @@ private:
    // Utility functions
 
    std::string toString() const; // Get string representation of the object data members (function with extended functionality)
-   Gamete createOneGamete() const; // Create one gamete
-   int calculateNGametes(int64_t, const Population<Host>&, Rng&) const; // Calculate the number of gametes produced by the host in the current reprodutive event
    };
 
    #endif // SYMBIONT_H
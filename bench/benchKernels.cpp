@@ -0,0 +1,355 @@
+// #### HOSYDY microbenchmarks
+// Microbenchmark executable for the genetic and demographic kernels of the model.
+// Usage: benchKernels [Ksymbiont] [Khost] [Eht] [mutRateS]
+// It prints one CSV row per kernel with the time per operation (ns/op) and the
+// number of heap allocations and allocated bytes per operation, so that the
+// output of two builds can be compared directly (e.g. with diff or R).
+// Compile it together with all the .cpp files of the model except main.cpp.
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint> // uint32_t and uint64_t types
+
+#include "Rng.h"
+#include "SourcePatch.h"
+#include "Patch.h"
+#include "Population.h"
+#include "Metapopulation.h"
+#include "Gamete.h"
+#include "Param.h"
+#include "AllocStats.h"
+#include "MutationScatter.h"
+#include "Genome.h"
+#include "LocusEffects.h"
+#include "LinkageMap.h"
+
+using namespace std;
+using namespace std::chrono;
+
+// ---Benchmark harness---
+
+static volatile uint64_t Sink = 0; // Prevents the compiler from discarding the results of the kernels
+
+// Short string representation of a parameter value (used in the Size column)
+static string num( double value ) {
+   ostringstream output;
+   output << value;
+   return output.str();
+}
+
+// Run kernel(i) for an increasing number of operations until the timed loop lasts at least MinSeconds,
+// and print a CSV row with the time and allocations per operation
+template<typename F>
+void runBench( const string& name, const string& size, F kernel ) {
+   const double MinSeconds = 0.2;
+   long nops = 16;
+   while ( true ) {
+      uint64_t allocs0 = AllocStats::getNAllocs();
+      uint64_t bytes0 = AllocStats::getNBytes();
+      auto start = steady_clock::now();
+      for ( long i = 0; i < nops; ++i ) { kernel( i ); }
+      double seconds = duration<double>( steady_clock::now() - start ).count();
+      if ( seconds >= MinSeconds || nops >= ( 1L << 30 ) ) {
+         double n = static_cast<double>( nops );
+         cout << name << ","
+            << size << ","
+            << nops << ","
+            << seconds * 1e9 / n << ","
+            << static_cast<double>( AllocStats::getNAllocs() - allocs0 ) / n << ","
+            << static_cast<double>( AllocStats::getNBytes() - bytes0 ) / n << "\n";
+         return;
+      }
+      nops *= 4;
+   }
+}
+
+int main( int argc, char* argv[] ) {
+
+   // Benchmark sizes
+   int ksymbiont = ( argc > 1 ) ? atoi( argv[1] ) : Param::getKsymbiont();
+   int khost = ( argc > 2 ) ? atoi( argv[2] ) : Param::getKhost();
+   double eht = ( argc > 3 ) ? atof( argv[3] ) : 0.1;
+   double mutrate = ( argc > 4 ) ? atof( argv[4] ) : 0.001;
+
+   // Parameters of the benchmark scenario (vectors sized to hold Khost hosts with Ksymbiont symbionts each)
+   Param::setKsymbiont( ksymbiont );
+   Param::setKhost( khost );
+   Param::setEht( eht );
+   Param::setSAb( ksymbiont );
+   Param::setSPrev( 1 );
+   Param::setHPopVecSize( static_cast<size_t>( khost ) * 4 );
+   Param::setSPopVecSize( static_cast<size_t>( ksymbiont ) * 5 );
+   Param::setScenID( "Bench" );
+   Param::initParam();
+
+   Rng rng;
+   rng.Rng_init();
+   SourcePatch continent;
+   Patch island;
+   Population<Host> hpop;
+   hpop.initPop( island );
+   Metapopulation<Population<Symbiont>> smpop;
+   smpop.initMetapop();
+   for ( int counter = 0; counter < khost; ++counter ) {
+      uint64_t newHostID = hpop.newIndFromSource( continent, rng );
+      smpop.newPopFromSource( continent, rng, hpop, newHostID );
+   }
+
+   // Symbionts and hosts used as input of the individual-level kernels
+   std::vector<Symbiont> symbionts;
+   std::vector<uint64_t> symbHostIDs;
+   for ( int counter = 0; counter < smpop.getN() && symbionts.size() < 4096; ++counter ) {
+      const Population<Symbiont>& spop = smpop.getMetapop()[counter];
+      for ( int i = 0; i < spop.getN() && symbionts.size() < 4096; ++i ) {
+         symbionts.push_back( spop.getInd( i ) );
+         symbHostIDs.push_back( spop.getPatchID() );
+      }
+   }
+   const size_t nsymb = symbionts.size();
+
+   string sizeS = "Ksymbiont=" + to_string( ksymbiont );
+   string sizeH = "Khost=" + to_string( khost );
+   string sizeM = sizeH + " Ksymbiont=" + to_string( ksymbiont ) + " Eht=" + num( eht );
+
+   cout << "Kernel,Size,NOps,NsPerOp,AllocsPerOp,BytesPerOp\n";
+
+   // Organism-level kernels
+   for ( bool legacy : { true, false } ) {
+      Rng::setLegacy( legacy );
+      runBench( "Organism::createOneHaplGen", sizeS + ( legacy ? " legacy" : " fast" ), [&]( long i ) {
+         Sink += ModelGenome::word32( symbionts[ i % nsymb ].createOneHaplGen(), 0 );
+      });
+   }
+   Rng::setLegacy( Param::getLegacyRng() );
+   LinkageMap::setDistances( std::vector<double>( Organism::getL() - 1, 1.0 / ( Organism::getL() - 1 ) ) ); // one Morgan
+   runBench( "Organism::createOneHaplGen", sizeS + " linkage map 1 M", [&]( long i ) {
+      Sink += ModelGenome::word32( symbionts[ i % nsymb ].createOneHaplGen(), 0 );
+   });
+   LinkageMap::setDistances( Param::getLinkDistances() );
+   runBench( "Organism::Phen_init", sizeS + ( Organism::getFixedPhenTable() ? " fixed table" : "" ), [&]( long i ) {
+      Symbiont& ind = symbionts[ i % nsymb ];
+      ind.Phen_init();
+      Sink += static_cast<uint64_t>( ind.getPhen() );
+   });
+   runBench( "Organism::sumHetLocInd", sizeS, [&]( long i ) {
+      Sink += symbionts[ i % nsymb ].sumHetLocInd();
+   });
+   std::vector<ModelGenome::Gen> gens;
+   for ( size_t i = 0; i < nsymb; ++i ) { gens.push_back( symbionts[i].getGen() ); }
+   runBench( "Organism::sumHetLoc(array)", sizeS + " (per genotype)", [&]( long i ) {
+      if ( i % nsymb == 0 ) { Sink += Organism::sumHetLoc( gens.data(), gens.size() ); }
+   });
+   std::vector<double> effects( Organism::getL() );
+   for ( int k = 0; k < Organism::getL(); ++k ) { effects[k] = ( k < 4 ) ? 1.0 : 0.1; } // major and minor loci
+   LocusEffects::setEffects( effects );
+   runBench( "LocusEffects::phenotype", sizeS, [&]( long i ) {
+      Sink += static_cast<uint64_t>( LocusEffects::phenotype( gens[ i % nsymb ] ) );
+   });
+   std::vector<double> phens( nsymb );
+   runBench( "LocusEffects::phenotypes(array)", sizeS + " (per genotype)", [&]( long i ) {
+      if ( i % nsymb == 0 ) {
+         LocusEffects::phenotypes( gens.data(), gens.size(), phens.data() );
+         Sink += static_cast<uint64_t>( phens[0] );
+      }
+   });
+   LocusEffects::setEffects( Param::getLocEffects() );
+
+   // Random number generation kernels
+   runBench( "Rng::random_uint32", Rng::getEngineName(), [&]( long ) {
+      Sink += Rng::random_uint32();
+   });
+   std::vector<uint32_t> bits( 4096 );
+   runBench( "Rng::fillRandomBits", "per 32-bit word", [&]( long i ) {
+      if ( i % 4096 == 0 ) {
+         Rng::fillRandomBits( bits.data(), bits.size() );
+         Sink += bits[0];
+      }
+   });
+   // Poisson sampling with the standard library distribution (legacy) and with the fast samplers of Rng
+   for ( double mean : { 1.0, 4.0, 40.0 } ) {
+      Rng::setLegacy( true );
+      runBench( "Rng::poisson", "mean=" + num( mean ) + " legacy", [&]( long ) {
+         Sink += rng.poisson( mean );
+      });
+      Rng::setLegacy( false );
+      runBench( "Rng::poisson", "mean=" + num( mean ) + " fast", [&]( long ) {
+         Sink += rng.poisson( mean );
+      });
+   }
+   Rng::setLegacy( true );
+   std::vector<double> means;
+   std::vector<int> counts;
+   for ( size_t i = 0; i < nsymb; ++i ) { means.push_back( Symbiont::meanNGametes( symbionts[i].getPhen(), hpop.getNsymbiont( symbHostIDs[i] ), hpop.getPhen( symbHostIDs[i] ) ) ); }
+   runBench( "Rng::poisson", "gamete means legacy", [&]( long i ) {
+      Sink += rng.poisson( means[ i % nsymb ] );
+   });
+   Rng::setLegacy( false );
+   runBench( "Rng::poisson(vector)", "gamete means fast (per mean)", [&]( long i ) {
+      if ( i % nsymb == 0 ) {
+         rng.poisson( means, counts );
+         Sink += counts[0];
+      }
+   });
+   Rng::setLegacy( Param::getLegacyRng() );
+   for ( bool legacy : { true, false } ) {
+      Rng::setLegacy( legacy );
+      for ( int k : { 8, 32 } ) {
+         runBench( "Rng::random_k_bits", "k=" + to_string( k ) + ( legacy ? " legacy" : " fast" ), [&]( long ) {
+            Sink += rng.random_k_bits( k );
+         });
+      }
+   }
+   Rng::setLegacy( Param::getLegacyRng() );
+   // Binomial sampling with the standard library distribution (legacy) and with the cached samplers
+   // (mutation: 64 alleles with mutRateS; horizontal transmission: Ksymbiont symbionts with Eht)
+   for ( bool legacy : { true, false } ) {
+      Rng::setLegacy( legacy );
+      runBench( "Rng::binomial", "n=64 p=" + num( mutrate ) + ( legacy ? " legacy" : " fast" ), [&]( long ) {
+         Sink += rng.binomial( 64, mutrate );
+      });
+      runBench( "Rng::binomial", "n=" + to_string( ksymbiont ) + " p=" + num( eht ) + ( legacy ? " legacy" : " fast" ), [&]( long i ) {
+         Sink += rng.binomial( ksymbiont - static_cast<int>( i % 8 ), eht );
+      });
+   }
+   Rng::setLegacy( Param::getLegacyRng() );
+   // Negative binomial sampling with Boost quantile inversion (legacy) and with the gamma-Poisson mixture
+   string sizeNB = "SAb=" + to_string( ksymbiont ) + " STheta=" + num( Param::getSTheta() );
+   for ( bool legacy : { true, false } ) {
+      Rng::setLegacy( legacy );
+      runBench( "Rng::negative_binomial", sizeNB + ( legacy ? " legacy" : " fast" ), [&]( long ) {
+         Sink += rng.negative_binomial( Param::getSAb(), Param::getSTheta() );
+      });
+      runBench( "Rng::negative_binomial_zt", sizeNB + ( legacy ? " legacy" : " fast" ), [&]( long ) {
+         Sink += rng.negative_binomial_zt( Param::getSAb(), Param::getSTheta() );
+      });
+   }
+   Rng::setLegacy( Param::getLegacyRng() );
+
+   // Gametes of one symbiont, one vector per symbiont (a Poisson number of gametes around Symbiont::meanNGametes, one createOneHaplGen per gamete)
+   runBench( "symbiont gametes (per symbiont)", sizeS, [&]( long i ) {
+      const Symbiont& symbiont = symbionts[ i % nsymb ];
+      int ngametes = rng.poisson( means[ i % nsymb ] );
+      std::vector<Gamete> gametes;
+      gametes.reserve( ngametes );
+      for ( int g = 0; g < ngametes; ++g ) { gametes.push_back( Gamete( symbiont.createOneHaplGen() ) ); }
+      Sink += gametes.size();
+   });
+
+   // Symbiont newborns without and with mutation (the difference isolates Population<Symbiont>::genMutation)
+   Population<Symbiont>& nbpop = *smpop.getPop( smpop.getMetapop()[0].getID() );
+   const uint64_t nbhost = nbpop.getPatchID();
+   const int nbcapacity = static_cast<int>( nbpop.getCapacity() );
+   Gamete gamete1( ModelGenome::haplotype( symbionts[0].getGen(), 0 ) );
+   Gamete gamete2( ModelGenome::haplotype( symbionts[ nsymb - 1 ].getGen(), 1 ) );
+   auto newBornKernel = [&]( long ) {
+      if ( nbpop.getN() == nbcapacity ) { // recycle the population vector
+         nbpop.setN( 0 );
+         hpop.setNsymbiont( nbhost, 0 );
+      }
+      nbpop.newBorn( hpop, rng, gamete1, gamete2 );
+   };
+   Symbiont::setmutRate( 0 );
+   runBench( "Population<Symbiont>::newBorn", sizeS + " mutRateS=0", newBornKernel );
+   Symbiont::setmutRate( mutrate );
+   runBench( "Population<Symbiont>::newBorn", sizeS + " mutRateS=" + num( mutrate ), newBornKernel );
+   // Same with the mutations scattered over a reproductive event of Ksymbiont newborns
+   MutationScatter mutations( mutrate );
+   runBench( "Population<Symbiont>::newBorn(MutationScatter)", sizeS + " mutRateS=" + num( mutrate ), [&]( long i ) {
+      if ( i % ksymbiont == 0 ) { mutations = MutationScatter( mutrate ); } // new reproductive event
+      if ( nbpop.getN() == nbcapacity ) { // recycle the population vector
+         nbpop.setN( 0 );
+         hpop.setNsymbiont( nbhost, 0 );
+      }
+      nbpop.newBorn( hpop, rng, gamete1, gamete2, mutations );
+   });
+   Symbiont::setmutRate( Param::getmutRateS() );
+   nbpop.setN( 0 );
+   hpop.setNsymbiont( nbhost, 0 );
+
+   // Reproduction of a population of Ksymbiont individuals with 2 distinct genotypes (fast samplers),
+   // by individuals and by genotype classes (the population is restored before each reproductive event)
+   Rng::setLegacy( false );
+   for ( int i = 0; i < ksymbiont; ++i ) {
+      Gamete parental( ModelGenome::haplotype( symbionts[ i % 2 ].getGen(), 0 ) );
+      nbpop.newBorn( hpop, rng, parental, parental );
+   }
+   const std::vector<Symbiont> lowdivpop = nbpop.getPop();
+   const int lowdivn = nbpop.getN();
+   for ( bool classes : { false, true } ) {
+      Population<Symbiont>::setGenotypeClasses( classes );
+      runBench( "Population<Symbiont>::popReproduction", sizeS + " 2 genotypes" + ( classes ? " by classes" : "" ), [&]( long ) {
+         nbpop.setPop( lowdivpop );
+         nbpop.setN( lowdivn );
+         hpop.setNsymbiont( nbhost, lowdivn );
+         nbpop.popReproduction( hpop, rng );
+         Sink += nbpop.getN();
+      });
+   }
+   Population<Symbiont>::setGenotypeClasses( Param::getGenotypeClasses() );
+   Rng::setLegacy( Param::getLegacyRng() );
+   nbpop.setN( 0 );
+   hpop.setNsymbiont( nbhost, 0 );
+
+   // Allele counts per genotype: bit-by-bit loop of the former sumAlToAlFreq (reference, single-word genome only) and AlleleCounter
+   std::vector<int> alfreq( Symbiont::getL() );
+#if GENOME_WORDS == 1
+   runBench( "allele count bit loop (reference)", sizeS, [&]( long i ) {
+      uint64_t gen = symbionts[ i % nsymb ].getGen();
+      for ( int k = 0; k < 32; ++k ) {
+         if ( gen & ( static_cast<uint64_t>( 1 ) << ( 31 - k ) ) ) { ++alfreq[k]; }
+         if ( gen & ( static_cast<uint64_t>( 1 ) << ( 63 - k ) ) ) { ++alfreq[k]; }
+      }
+   });
+#endif
+   ModelGenome::Counter alleles;
+   runBench( "AlleleCounter::add", sizeS + " GENOME_WORDS=" + to_string( ModelGenome::NWords ), [&]( long i ) {
+      alleles.add( symbionts[ i % nsymb ].getGen() );
+   });
+   alleles.addTo( alfreq );
+   Sink += alfreq[0];
+   // Check AlleleCounter against a bit-by-bit count of the benchmark genotypes (any GENOME_WORDS)
+   std::vector<int> refCounts( Symbiont::getL() ), checkCounts( Symbiont::getL() );
+   ModelGenome::Counter checkAlleles;
+   for ( size_t i = 0; i < nsymb; ++i ) {
+      const ModelGenome::Gen& gen = symbionts[i].getGen();
+      for ( int bit = 0; bit < 64 * ModelGenome::NWords; ++bit ) {
+         int locus = ModelGenome::locusOfBit( bit );
+         if ( locus < Symbiont::getL() && ( ( ModelGenome::word( gen, bit / 64 ) >> ( bit % 64 ) ) & 1 ) ) { ++refCounts[locus]; }
+      }
+      checkAlleles.add( gen );
+   }
+   checkAlleles.addTo( checkCounts );
+   for ( int k = 0; k < Symbiont::getL(); ++k ) {
+      if ( checkCounts[k] != refCounts[k] ) {
+         cerr << "Error: AlleleCounter counts " << checkCounts[k] << " alleles \"1\" at locus " << k << " instead of " << refCounts[k] << endl;
+         exit(1);
+      }
+   }
+
+   // Host population scans (abundance statistics of the output)
+   runBench( "Population<Host>::getSPrev+getVarSAb", sizeH, [&]( long ) {
+      Sink += static_cast<uint64_t>( ( hpop.getSPrev() + hpop.getVarSAb() ) * 1e6 );
+   });
+
+   // Metapopulation-level kernels
+   runBench( "Metapopulation::getAlFreq", sizeM, [&]( long ) {
+      Sink += smpop.getAlFreq()[0];
+   });
+   runBench( "Metapopulation::getHexp", sizeM, [&]( long ) {
+      Sink += static_cast<uint64_t>( smpop.getHexp() * 1e6 );
+   });
+   runBench( "Metapopulation::getHobs", sizeM, [&]( long ) {
+      Sink += static_cast<uint64_t>( smpop.getHobs() * 1e6 );
+   });
+   runBench( "Metapopulation::horizTrans", sizeM, [&]( long ) {
+      smpop.horizTrans( rng, hpop );
+   });
+
+   cout << flush;
+   return 0;
+}